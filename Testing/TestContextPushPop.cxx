@@ -0,0 +1,91 @@
+#include "vtkNew.h"
+#include "vtkRenderer.h"
+
+// clang-format off
+#include "vtkGlfwOpenGLRenderWindow.h"
+#include "vtkGlfwTestBudget.h"
+// clang-format on
+
+#include <GLFW/glfw3.h>
+
+namespace {
+GLFWwindow*
+contextOf(vtkGlfwOpenGLRenderWindow* window)
+{
+  return static_cast<GLFWwindow*>(window->GetGenericWindowId());
+}
+}
+
+// Nest PushContext()/PopContext() across two windows; every pop has to
+// bring back exactly the context that was current before the push, and
+// switches are only counted when the context really changed.
+int
+main(int argc, char* argv[])
+{
+  vtkGlfwTestBudget budget("TestContextPushPop", argc, argv);
+  const int rounds = 2000;
+
+  vtkNew<vtkRenderer> rendererA;
+  vtkNew<vtkGlfwOpenGLRenderWindow> windowA;
+  windowA->SetSize(160, 120);
+  windowA->SetUnfocusedFrameRate(0.0);
+  windowA->AddRenderer(rendererA);
+  vtkNew<vtkRenderer> rendererB;
+  vtkNew<vtkGlfwOpenGLRenderWindow> windowB;
+  windowB->SetSize(160, 120);
+  windowB->SetUnfocusedFrameRate(0.0);
+  windowB->AddRenderer(rendererB);
+
+  int result = [&]() {
+    windowA->Render();
+    windowB->Render();
+    vtkGlfwTestCheck(contextOf(windowA) && contextOf(windowB));
+
+    windowA->MakeCurrent();
+    vtkGlfwTestCheck(windowA->IsCurrent() && !windowB->IsCurrent());
+    const vtkIdType switchesA = windowA->GetNumberOfContextSwitches();
+    const vtkIdType switchesB = windowB->GetNumberOfContextSwitches();
+
+    for (int i = 0; i < rounds; ++i) {
+      windowB->PushContext();
+      vtkGlfwTestCheck(glfwGetCurrentContext() == contextOf(windowB));
+      // pushing the current context again must not switch
+      windowB->PushContext();
+      vtkGlfwTestCheck(windowB->IsCurrent());
+      windowA->PushContext();
+      vtkGlfwTestCheck(windowA->IsCurrent());
+      windowA->PopContext();
+      vtkGlfwTestCheck(windowB->IsCurrent());
+      windowB->PopContext();
+      vtkGlfwTestCheck(windowB->IsCurrent());
+      windowB->PopContext();
+      vtkGlfwTestCheck(glfwGetCurrentContext() == contextOf(windowA));
+    }
+    // each round goes to B, to A, back to B and back to A
+    const vtkIdType switches = windowA->GetNumberOfContextSwitches() -
+                               switchesA +
+                               windowB->GetNumberOfContextSwitches() -
+                               switchesB;
+    vtkGlfwTestCheck(switches == 4 * vtkIdType(rounds));
+    budget.AddEvents(switches);
+
+    // from no current context back to none
+    glfwMakeContextCurrent(nullptr);
+    windowA->PushContext();
+    vtkGlfwTestCheck(windowA->IsCurrent());
+    windowA->PopContext();
+    vtkGlfwTestCheck(glfwGetCurrentContext() == nullptr);
+
+    // both windows still render after all the switching
+    const vtkIdType framesA = windowA->GetNumberOfFrames();
+    const vtkIdType framesB = windowB->GetNumberOfFrames();
+    windowA->Render();
+    windowB->Render();
+    vtkGlfwTestCheck(windowA->GetNumberOfFrames() == framesA + 1);
+    vtkGlfwTestCheck(windowB->GetNumberOfFrames() == framesB + 1);
+    return EXIT_SUCCESS;
+  }();
+  budget.AddFrames(windowA->GetNumberOfFrames() +
+                   windowB->GetNumberOfFrames());
+  return budget.Finish(result);
+}
@@ -0,0 +1,179 @@
+#include "vtkCallbackCommand.h"
+#include "vtkCommand.h"
+#include "vtkNew.h"
+#include "vtkRenderer.h"
+
+// clang-format off
+#include "vtkGlfwFrameStreamClient.h"
+#include "vtkGlfwFrameStreamer.h"
+#include "vtkGlfwOpenGLRenderWindow.h"
+#include "vtkGlfwRenderWindowInteractor.h"
+#include "vtkGlfwTestBudget.h"
+// clang-format on
+
+#include <GLFW/glfw3.h>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace {
+struct ButtonEvents
+{
+  int Pressed = 0;
+  int Released = 0;
+  int Position[2] = { 0, 0 };
+};
+
+void
+countButton(vtkObject* caller, unsigned long event, void* clientData, void*)
+{
+  auto interactor = static_cast<vtkRenderWindowInteractor*>(caller);
+  auto events = static_cast<ButtonEvents*>(clientData);
+  if (event == vtkCommand::LeftButtonPressEvent) {
+    ++events->Pressed;
+  } else {
+    ++events->Released;
+  }
+  interactor->GetEventPosition(events->Position);
+}
+
+// the streamer accepts on its own thread
+bool
+waitForClient(vtkGlfwFrameStreamer* streamer, bool connected)
+{
+  for (int i = 0; i < 200; ++i) {
+    if (streamer->IsClientConnected() == connected) {
+      return true;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  return false;
+}
+
+bool
+hasSignature(const std::vector<unsigned char>& payload, uint32_t format)
+{
+  static const unsigned char jpeg[] = { 0xff, 0xd8, 0xff };
+  static const unsigned char png[] = { 0x89, 'P', 'N', 'G' };
+  const unsigned char* expected =
+    format == vtkGlfwFrameStream::FORMAT_PNG ? png : jpeg;
+  const size_t size = format == vtkGlfwFrameStream::FORMAT_PNG ? 4 : 3;
+  return payload.size() > size &&
+         std::equal(expected, expected + size, payload.begin());
+}
+}
+
+// Stream a window to vtkGlfwFrameStreamClient over loopback: every
+// rendered frame arrives once, in order, at full size and in the chosen
+// format, input sent back reaches the interactor, and a newer client takes
+// the stream over from the old one.
+int
+main(int argc, char* argv[])
+{
+  vtkGlfwTestBudget budget("TestFrameStreamLoopback", argc, argv);
+  const int width = 320;
+  const int height = 240;
+  const int frames = 30;
+
+  vtkNew<vtkRenderer> renderer;
+  vtkNew<vtkGlfwOpenGLRenderWindow> window;
+  window->SetSize(width, height);
+  window->SetUnfocusedFrameRate(0.0);
+  window->AddRenderer(renderer);
+  vtkNew<vtkGlfwRenderWindowInteractor> interactor;
+  interactor->SetRenderWindow(window);
+  interactor->SetInteractorStyle(nullptr);
+
+  ButtonEvents events;
+  vtkNew<vtkCallbackCommand> observer;
+  observer->SetCallback(countButton);
+  observer->SetClientData(&events);
+  interactor->AddObserver(vtkCommand::LeftButtonPressEvent, observer);
+  interactor->AddObserver(vtkCommand::LeftButtonReleaseEvent, observer);
+
+  vtkNew<vtkGlfwFrameStreamer> streamer;
+  streamer->SetRenderWindow(window);
+  streamer->SetInteractor(interactor);
+  vtkNew<vtkGlfwFrameStreamClient> client;
+  vtkNew<vtkGlfwFrameStreamClient> successor;
+  vtkIdType received = 0;
+
+  int result = [&]() {
+    interactor->Initialize();
+    vtkGlfwTestCheck(streamer->Start(0));
+    vtkGlfwTestCheck(streamer->GetPort() > 0);
+    vtkGlfwTestCheck(client->Connect(streamer->GetPort()));
+    vtkGlfwTestCheck(waitForClient(streamer, true));
+
+    vtkGlfwFrameStream::FrameHeader header;
+    std::vector<unsigned char> payload;
+    uint32_t last = 0;
+    for (int i = 0; i < 2 * frames; ++i) {
+      const bool png = i >= frames;
+      streamer->SetFormat(png ? vtkGlfwFrameStreamer::FORMAT_PNG
+                              : vtkGlfwFrameStreamer::FORMAT_JPEG);
+      // a new picture every frame, unchanged ones are not sent
+      renderer->SetBackground(i % 2, double(i) / (2 * frames), 0.5);
+      window->Render();
+      vtkGlfwTestCheck(client->ReceiveFrame(header, payload, 5.0));
+      ++received;
+      vtkGlfwTestCheck(header.Magic == vtkGlfwFrameStream::Magic);
+      vtkGlfwTestCheck(int32_t(header.Sequence - last) > 0);
+      last = header.Sequence;
+      // the client keeps up, so the resolution stays
+      vtkGlfwTestCheck(header.Downscale == 1);
+      vtkGlfwTestCheck(int(header.Width) == width);
+      vtkGlfwTestCheck(int(header.Height) == height);
+      vtkGlfwTestCheck(header.Format ==
+                       uint32_t(png ? vtkGlfwFrameStream::FORMAT_PNG
+                                    : vtkGlfwFrameStream::FORMAT_JPEG));
+      vtkGlfwTestCheck(header.PayloadSize == payload.size());
+      vtkGlfwTestCheck(hasSignature(payload, header.Format));
+    }
+
+    // input goes the other way, into the interactor's queue
+    vtkGlfwFrameStream::InputMessage message = {};
+    message.Type = vtkGlfwFrameStream::MESSAGE_MOUSE_BUTTON;
+    message.X = 10;
+    message.Y = 20;
+    message.Button = GLFW_MOUSE_BUTTON_LEFT;
+    message.Action = GLFW_PRESS;
+    vtkGlfwTestCheck(client->SendInput(message));
+    message.Action = GLFW_RELEASE;
+    vtkGlfwTestCheck(client->SendInput(message));
+    const double deadline = glfwGetTime() + 2.0;
+    while (events.Released == 0 && glfwGetTime() < deadline) {
+      interactor->WaitAndProcessEvents(0.01);
+    }
+    vtkGlfwTestCheck(events.Pressed == 1 && events.Released == 1);
+    vtkGlfwTestCheck(events.Position[0] == 10);
+    vtkGlfwTestCheck(events.Position[1] == height - 1 - 20);
+
+    // the newest viewer wins; the old one is hung up on, and frames
+    // encoded for it are never sent to the new one
+    vtkGlfwTestCheck(successor->Connect(streamer->GetPort()));
+    vtkGlfwTestCheck(!client->ReceiveFrame(header, payload, 5.0));
+    // frames rendered before the successor is accepted go nowhere
+    bool taken = false;
+    for (int i = 0; i < 50 && !taken; ++i) {
+      renderer->SetBackground(0.0, 1.0, i / 50.0);
+      window->Render();
+      taken = successor->ReceiveFrame(header, payload, 0.1);
+    }
+    vtkGlfwTestCheck(taken);
+    ++received;
+    vtkGlfwTestCheck(int32_t(header.Sequence - last) > 0);
+
+    successor->Disconnect();
+    vtkGlfwTestCheck(waitForClient(streamer, false));
+    streamer->Stop();
+    vtkGlfwTestCheck(streamer->GetPort() == 0);
+    return EXIT_SUCCESS;
+  }();
+  streamer->Stop();
+  budget.AddFrames(received);
+  budget.AddEvents(interactor->GetNumberOfEvents());
+  return budget.Finish(result);
+}
@@ -0,0 +1,128 @@
+#include "vtkCallbackCommand.h"
+#include "vtkCommand.h"
+#include "vtkNew.h"
+#include "vtkRenderer.h"
+
+// clang-format off
+#include "vtkGlfwOpenGLRenderWindow.h"
+#include "vtkGlfwRenderWindowInteractor.h"
+#include "vtkGlfwTestBudget.h"
+// clang-format on
+
+#include <GLFW/glfw3.h>
+
+#include <map>
+
+namespace {
+struct ButtonEvents
+{
+  std::map<unsigned long, int> Count;
+  int Position[2] = { 0, 0 };
+  int Shift = 0;
+  int Control = 0;
+};
+
+void
+countButton(vtkObject* caller, unsigned long event, void* clientData, void*)
+{
+  auto interactor = static_cast<vtkRenderWindowInteractor*>(caller);
+  auto events = static_cast<ButtonEvents*>(clientData);
+  ++events->Count[event];
+  interactor->GetEventPosition(events->Position);
+  events->Shift = interactor->GetShiftKey();
+  events->Control = interactor->GetControlKey();
+}
+}
+
+// Press and release every mouse button through InjectEvent(); each GLFW
+// button has to map to its own VTK event, exactly once, at the flipped
+// position and with the modifiers it was sent with.
+int
+main(int argc, char* argv[])
+{
+  vtkGlfwTestBudget budget("TestMouseButtonDispatch", argc, argv);
+  const int width = 320;
+  const int height = 240;
+  const int rounds = 5000;
+  // dispatched per ProcessEvents(), like a burst from a remote viewer
+  const int batch = 50;
+
+  vtkNew<vtkRenderer> renderer;
+  vtkNew<vtkGlfwOpenGLRenderWindow> window;
+  window->SetSize(width, height);
+  window->SetUnfocusedFrameRate(0.0);
+  window->AddRenderer(renderer);
+  vtkNew<vtkGlfwRenderWindowInteractor> interactor;
+  interactor->SetRenderWindow(window);
+  interactor->SetInteractorStyle(nullptr);
+
+  ButtonEvents events;
+  vtkNew<vtkCallbackCommand> observer;
+  observer->SetCallback(countButton);
+  observer->SetClientData(&events);
+  const unsigned long buttonEvents[] = {
+    vtkCommand::LeftButtonPressEvent,    vtkCommand::LeftButtonReleaseEvent,
+    vtkCommand::MiddleButtonPressEvent,  vtkCommand::MiddleButtonReleaseEvent,
+    vtkCommand::RightButtonPressEvent,   vtkCommand::RightButtonReleaseEvent
+  };
+  for (unsigned long event : buttonEvents) {
+    interactor->AddObserver(event, observer);
+  }
+
+  using InjectedEvent = vtkGlfwRenderWindowInteractor::InjectedEvent;
+  auto inject = [&](int button, int action, int mods) {
+    InjectedEvent event;
+    event.Type = InjectedEvent::MOUSE_BUTTON;
+    event.X = 10;
+    event.Y = 20;
+    event.Button = button;
+    event.Action = action;
+    event.Mods = mods;
+    interactor->InjectEvent(event);
+  };
+
+  int result = [&]() {
+    interactor->Initialize();
+    vtkGlfwTestCheck(interactor->GetEnabled());
+    const vtkIdType before = interactor->GetNumberOfEvents();
+
+    const int buttons[] = { GLFW_MOUSE_BUTTON_LEFT,
+                            GLFW_MOUSE_BUTTON_MIDDLE,
+                            GLFW_MOUSE_BUTTON_RIGHT };
+    for (int round = 0; round < rounds; ++round) {
+      for (int button : buttons) {
+        inject(button, GLFW_PRESS, 0);
+        inject(button, GLFW_RELEASE, 0);
+      }
+      if ((round + 1) % batch == 0) {
+        interactor->ProcessEvents();
+      }
+    }
+    interactor->ProcessEvents();
+    for (unsigned long event : buttonEvents) {
+      vtkGlfwTestCheck(events.Count[event] == rounds);
+    }
+    // GLFW's y goes down from the top, VTK's up from the bottom
+    vtkGlfwTestCheck(events.Position[0] == 10);
+    vtkGlfwTestCheck(events.Position[1] == height - 1 - 20);
+
+    // buttons VTK has no event for are dropped, modifiers come along
+    inject(GLFW_MOUSE_BUTTON_4, GLFW_PRESS, 0);
+    inject(GLFW_MOUSE_BUTTON_4, GLFW_RELEASE, 0);
+    inject(GLFW_MOUSE_BUTTON_LEFT, GLFW_PRESS, GLFW_MOD_SHIFT);
+    interactor->ProcessEvents();
+    vtkGlfwTestCheck(events.Count[vtkCommand::LeftButtonPressEvent] ==
+                     rounds + 1);
+    vtkGlfwTestCheck(events.Shift && !events.Control);
+    inject(GLFW_MOUSE_BUTTON_LEFT, GLFW_RELEASE, GLFW_MOD_CONTROL);
+    interactor->ProcessEvents();
+    vtkGlfwTestCheck(!events.Shift && events.Control);
+
+    const vtkIdType handled = interactor->GetNumberOfEvents() - before;
+    vtkGlfwTestCheck(handled == 6 * vtkIdType(rounds) + 4);
+    budget.AddEvents(handled);
+    return EXIT_SUCCESS;
+  }();
+  budget.AddFrames(window->GetNumberOfFrames());
+  return budget.Finish(result);
+}
@@ -0,0 +1,141 @@
+#include "vtkNew.h"
+#include "vtkRenderer.h"
+
+// clang-format off
+#include "vtkGlfwOpenGLRenderWindow.h"
+#include "vtkGlfwSharedFrameExporter.h"
+#include "vtkGlfwSharedFrameReader.h"
+#include "vtkGlfwTestBudget.h"
+// clang-format on
+
+#include <GLFW/glfw3.h>
+
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+namespace {
+// let the size callback catch up with the window system
+bool
+waitForFramebuffer(vtkGlfwOpenGLRenderWindow* window, int width, int height)
+{
+  const double deadline = glfwGetTime() + 2.0;
+  while (glfwGetTime() < deadline) {
+    const int* size = window->GetFramebufferSize();
+    if (size[0] >= width && size[1] >= height) {
+      return true;
+    }
+    glfwWaitEventsTimeout(0.01);
+  }
+  return false;
+}
+
+bool
+isGreen(const vtkGlfwSharedFrameReader::Frame& frame)
+{
+  const size_t last = (size_t(frame.Width) * frame.Height - 1) * 4;
+  for (size_t offset : { size_t(0), last }) {
+    const unsigned char* pixel = frame.Color + offset;
+    if (pixel[0] != 0 || pixel[1] != 255 || pixel[2] != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+}
+
+// Export into a ring of three slots: a peeked frame stays valid until its
+// slot comes round again, a larger window makes the exporter replace the
+// ring, and the reader follows it there, frame sizes and sequence numbers
+// intact, before and after the replaced ring wraps.
+int
+main(int argc, char* argv[])
+{
+  vtkGlfwTestBudget budget("TestSharedFrameRingGrowth", argc, argv);
+  const std::string name = "/vtkglfw-test-" + std::to_string(getpid());
+  const int slots = 3;
+
+  vtkNew<vtkRenderer> renderer;
+  renderer->SetBackground(0.0, 1.0, 0.0);
+  vtkNew<vtkGlfwOpenGLRenderWindow> window;
+  window->SetSize(64, 48);
+  window->SetShowWindow(false);
+  window->SetUnfocusedFrameRate(0.0);
+  window->AddRenderer(renderer);
+  vtkNew<vtkGlfwSharedFrameExporter> exporter;
+  exporter->SetRenderWindow(window);
+  exporter->SetNumberOfSlots(slots);
+  vtkNew<vtkGlfwSharedFrameReader> reader;
+
+  vtkGlfwSharedFrameReader::Frame frame;
+  std::vector<unsigned char> color;
+  std::vector<float> depth;
+  auto exportFrame = [&]() {
+    window->Render();
+    exporter->Flush();
+  };
+  int result = [&]() {
+    window->Render();
+    vtkGlfwTestCheck(exporter->Start(name.c_str()));
+    vtkGlfwTestCheck(reader->Open(name.c_str()));
+
+    exportFrame();
+    vtkGlfwSharedFrameReader::Frame peeked;
+    vtkGlfwTestCheck(reader->Peek(peeked));
+    budget.AddEvents(1);
+    vtkGlfwTestCheck(peeked.Sequence == 1);
+    vtkGlfwTestCheck(reader->IsValid(peeked));
+    // the other slots fill up first, then the peeked one is overwritten
+    for (int i = 1; i < slots; ++i) {
+      exportFrame();
+      vtkGlfwTestCheck(reader->IsValid(peeked));
+    }
+    exportFrame();
+    vtkGlfwTestCheck(!reader->IsValid(peeked));
+
+    // a larger frame does not fit the slots, so the ring is replaced
+    vtkGlfwTestCheck(reader->Peek(peeked));
+    budget.AddEvents(1);
+    window->SetSize(200, 150);
+    vtkGlfwTestCheck(waitForFramebuffer(window, 200, 150));
+    exportFrame();
+    vtkGlfwTestCheck(reader->Read(frame, color, depth));
+    budget.AddEvents(1);
+    vtkGlfwTestCheck(frame.Width == 200 && frame.Height == 150);
+    vtkGlfwTestCheck(color.size() == size_t(200) * 150 * 4);
+    vtkGlfwTestCheck(isGreen(frame));
+    // numbering carries on from the old ring
+    vtkGlfwTestCheck(frame.Sequence == slots + 2);
+    vtkGlfwTestCheck(int64_t(frame.Sequence) ==
+                     exporter->GetNumberOfFramesExported());
+    // and frames peeked from the old one are gone
+    vtkGlfwTestCheck(!reader->IsValid(peeked));
+
+    // the new ring wraps like the old one
+    vtkGlfwTestCheck(reader->Peek(peeked));
+    budget.AddEvents(1);
+    for (int i = 1; i <= 2 * slots; ++i) {
+      exportFrame();
+      vtkGlfwTestCheck(reader->Read(frame, color, depth));
+      budget.AddEvents(1);
+      vtkGlfwTestCheck(frame.Sequence == peeked.Sequence + i);
+      vtkGlfwTestCheck(frame.Width == 200 && frame.Height == 150);
+      vtkGlfwTestCheck(reader->IsValid(peeked) == (i < slots));
+    }
+
+    // smaller frames fit the grown slots
+    window->SetSize(64, 48);
+    exportFrame();
+    vtkGlfwTestCheck(reader->Read(frame, color, depth));
+    budget.AddEvents(1);
+    vtkGlfwTestCheck(frame.Width == 64 && frame.Height == 48);
+    vtkGlfwTestCheck(color.size() == size_t(64) * 48 * 4);
+    vtkGlfwTestCheck(isGreen(frame));
+    vtkGlfwTestCheck(frame.Sequence == peeked.Sequence + 2 * slots + 1);
+    return EXIT_SUCCESS;
+  }();
+  exporter->Stop();
+  budget.AddFrames(window->GetNumberOfFrames());
+  return budget.Finish(result);
+}
@@ -0,0 +1,128 @@
+#include "vtkNew.h"
+#include "vtkRenderer.h"
+
+// clang-format off
+#include "vtkGlfwOpenGLRenderWindow.h"
+#include "vtkGlfwSharedFrameExporter.h"
+#include "vtkGlfwSharedFrameReader.h"
+#include "vtkGlfwTestBudget.h"
+// clang-format on
+
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+namespace {
+bool
+isColor(const unsigned char* pixel, int r, int g, int b)
+{
+  return pixel[0] == r && pixel[1] == g && pixel[2] == b;
+}
+}
+
+// Export frames and read them back in the same process: colors, depths,
+// sizes and sequence numbers have to come through, frames wait for a later
+// one or Flush() to be published, tiled renders export nothing, and the
+// reader follows the exporter through a restart.
+int
+main(int argc, char* argv[])
+{
+  vtkGlfwTestBudget budget("TestSharedFrameRoundTrip", argc, argv);
+  const std::string name = "/vtkglfw-test-" + std::to_string(getpid());
+  const int width = 64;
+  const int height = 48;
+
+  vtkNew<vtkRenderer> renderer;
+  vtkNew<vtkGlfwOpenGLRenderWindow> window;
+  window->SetSize(width, height);
+  window->SetShowWindow(false);
+  window->SetUnfocusedFrameRate(0.0);
+  window->AddRenderer(renderer);
+  vtkNew<vtkGlfwSharedFrameExporter> exporter;
+  exporter->SetRenderWindow(window);
+  exporter->SetExportDepth(true);
+  vtkNew<vtkGlfwSharedFrameReader> reader;
+
+  vtkGlfwSharedFrameReader::Frame frame;
+  std::vector<unsigned char> color;
+  std::vector<float> depth;
+  int result = [&]() {
+    window->Render();
+    vtkGlfwTestCheck(exporter->Start(name.c_str()));
+    vtkGlfwTestCheck(reader->Open(name.c_str()));
+    vtkGlfwTestCheck(!reader->Peek(frame));
+
+    renderer->SetBackground(1.0, 0.0, 0.0);
+    window->Render();
+    exporter->Flush();
+    vtkGlfwTestCheck(exporter->GetNumberOfFramesExported() == 1);
+    vtkGlfwTestCheck(reader->Read(frame, color, depth));
+    budget.AddEvents(1);
+    vtkGlfwTestCheck(frame.Sequence == 1);
+    vtkGlfwTestCheck(frame.Width == width && frame.Height == height);
+    vtkGlfwTestCheck(color.size() == size_t(width) * height * 4);
+    vtkGlfwTestCheck(depth.size() == size_t(width) * height);
+    vtkGlfwTestCheck(frame.Color == color.data());
+    vtkGlfwTestCheck(frame.Depth == depth.data());
+    vtkGlfwTestCheck(isColor(frame.Color, 255, 0, 0));
+    vtkGlfwTestCheck(isColor(frame.Color + color.size() - 4, 255, 0, 0));
+    // nothing drawn, the depth buffer is as cleared
+    vtkGlfwTestCheck(frame.Depth[0] == 1.0f);
+    const uint64_t first = frame.Timestamp;
+
+    // without Flush() a frame waits for a later one to be published
+    renderer->SetBackground(0.0, 1.0, 0.0);
+    window->Render();
+    vtkGlfwTestCheck(!reader->WaitForFrame(1, 0.0));
+    renderer->SetBackground(0.0, 0.0, 1.0);
+    window->Render();
+    exporter->Flush();
+    vtkGlfwTestCheck(exporter->GetNumberOfFramesExported() == 3);
+    vtkGlfwTestCheck(reader->Peek(frame));
+    budget.AddEvents(1);
+    vtkGlfwTestCheck(frame.Sequence == 3);
+    vtkGlfwTestCheck(frame.Timestamp > first);
+    vtkGlfwTestCheck(isColor(frame.Color, 0, 0, 255));
+    vtkGlfwTestCheck(reader->IsValid(frame));
+
+    // colors only
+    exporter->SetExportDepth(false);
+    window->Render();
+    exporter->Flush();
+    vtkGlfwTestCheck(reader->Read(frame, color, depth));
+    budget.AddEvents(1);
+    vtkGlfwTestCheck(frame.Sequence == 4);
+    vtkGlfwTestCheck(isColor(frame.Color, 0, 0, 255));
+    vtkGlfwTestCheck(!frame.Depth && depth.empty());
+
+    // the tiles of a tiled render are not frames and are never exported
+    const vtkIdType frames = window->GetNumberOfFrames();
+    window->SetMaximumTileSize(32);
+    vtkGlfwTestCheck(window->RenderTiled(
+      2 * width, 2 * height, [](int, const unsigned char*) { return true; }));
+    exporter->Flush();
+    vtkGlfwTestCheck(window->GetNumberOfFrames() == frames);
+    vtkGlfwTestCheck(exporter->GetNumberOfFramesExported() == 4);
+    vtkGlfwTestCheck(reader->Peek(frame));
+    vtkGlfwTestCheck(frame.Sequence == 4);
+    vtkGlfwTestCheck(frame.Width == width && frame.Height == height);
+
+    // a stopped exporter takes its frames along, a restarted one starts
+    // over, and the reader finds it again by name
+    exporter->Stop();
+    vtkGlfwTestCheck(!reader->Peek(frame));
+    vtkGlfwTestCheck(exporter->Start(name.c_str()));
+    renderer->SetBackground(1.0, 1.0, 0.0);
+    window->Render();
+    exporter->Flush();
+    vtkGlfwTestCheck(reader->Read(frame, color, depth));
+    budget.AddEvents(1);
+    vtkGlfwTestCheck(frame.Sequence == 1);
+    vtkGlfwTestCheck(isColor(frame.Color, 255, 255, 0));
+    return EXIT_SUCCESS;
+  }();
+  exporter->Stop();
+  budget.AddFrames(window->GetNumberOfFrames());
+  return budget.Finish(result);
+}
@@ -0,0 +1,93 @@
+#include "vtkCallbackCommand.h"
+#include "vtkCommand.h"
+#include "vtkNew.h"
+#include "vtkRenderer.h"
+
+// clang-format off
+#include "vtkGlfwOpenGLRenderWindow.h"
+#include "vtkGlfwRenderWindowInteractor.h"
+#include "vtkGlfwTestBudget.h"
+// clang-format on
+
+#include <GLFW/glfw3.h>
+
+#include <map>
+
+namespace {
+struct TimerCounts
+{
+  std::map<int, int> Fired;
+  int Total = 0;
+};
+
+void
+countTimer(vtkObject*, unsigned long, void* clientData, void* callData)
+{
+  auto counts = static_cast<TimerCounts*>(clientData);
+  ++counts->Fired[*static_cast<int*>(callData)];
+  ++counts->Total;
+}
+}
+
+// Repeating and one-shot timers fired by an event loop that sleeps
+// between them: the repeating timer keeps its period, the one-shot timer
+// fires once and is gone, and a destroyed timer stays quiet.
+int
+main(int argc, char* argv[])
+{
+  vtkGlfwTestBudget budget("TestTimers", argc, argv);
+  const unsigned long period = 10;
+  const int repeats = 50;
+
+  vtkNew<vtkRenderer> renderer;
+  vtkNew<vtkGlfwOpenGLRenderWindow> window;
+  window->SetSize(160, 120);
+  window->SetUnfocusedFrameRate(0.0);
+  window->AddRenderer(renderer);
+  vtkNew<vtkGlfwRenderWindowInteractor> interactor;
+  interactor->SetRenderWindow(window);
+  interactor->SetInteractorStyle(nullptr);
+
+  TimerCounts counts;
+  vtkNew<vtkCallbackCommand> observer;
+  observer->SetCallback(countTimer);
+  observer->SetClientData(&counts);
+  interactor->AddObserver(vtkCommand::TimerEvent, observer);
+
+  int result = [&]() {
+    interactor->Initialize();
+    vtkGlfwTestCheck(interactor->GetEnabled());
+
+    const double start = glfwGetTime();
+    const int repeating = interactor->CreateRepeatingTimer(period);
+    const int oneShot = interactor->CreateOneShotTimer(5 * period);
+    vtkGlfwTestCheck(repeating > 0 && oneShot > 0);
+    vtkGlfwTestCheck(interactor->IsOneShotTimer(oneShot));
+    // nothing else is due, so the loop may sleep until the first timer
+    const double timeout = interactor->GetEventTimeout();
+    vtkGlfwTestCheck(timeout >= 0.0 && timeout <= period / 1000.0);
+
+    const double deadline = start + 10.0;
+    while (counts.Fired[repeating] < repeats && glfwGetTime() < deadline) {
+      vtkGlfwTestCheck(interactor->WaitAndProcessEvents(1.0));
+    }
+    const double elapsed = glfwGetTime() - start;
+    vtkGlfwTestCheck(counts.Fired[repeating] == repeats);
+    // missed periods are skipped, never made up for
+    vtkGlfwTestCheck(elapsed >= repeats * period / 1000.0);
+    vtkGlfwTestCheck(counts.Fired[oneShot] == 1);
+    vtkGlfwTestCheck(!interactor->IsOneShotTimer(oneShot));
+
+    vtkGlfwTestCheck(interactor->DestroyTimer(repeating));
+    const double quiet = glfwGetTime() + 5 * period / 1000.0;
+    while (glfwGetTime() < quiet) {
+      interactor->WaitAndProcessEvents(quiet - glfwGetTime());
+    }
+    vtkGlfwTestCheck(counts.Fired[repeating] == repeats);
+    vtkGlfwTestCheck(counts.Total == repeats + 1);
+    return EXIT_SUCCESS;
+  }();
+  budget.AddFrames(window->GetNumberOfFrames());
+  budget.AddEvents(counts.Total);
+  return budget.Finish(result);
+}
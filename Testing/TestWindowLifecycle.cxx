@@ -0,0 +1,70 @@
+#include "vtkNew.h"
+#include "vtkRenderer.h"
+
+// clang-format off
+#include "vtkGlfwOpenGLRenderWindow.h"
+#include "vtkGlfwTestBudget.h"
+// clang-format on
+
+#include <string>
+
+namespace {
+const char* const backendNames[] = { "Auto", "Display", "EGL", "OSMesa" };
+}
+
+// Create, render, finalize, re-initialize and destroy windows over and
+// over; every cycle has to come back with a working context. The cold
+// start of the first window is recorded under the backend's name, so runs
+// with different VTKGLFW_BACKEND values can be compared.
+int
+main(int argc, char* argv[])
+{
+  vtkGlfwTestBudget budget("TestWindowLifecycle", argc, argv);
+  const int cycles = 5;
+  const int frames = 20;
+
+  int result = [&]() {
+    for (int cycle = 0; cycle < cycles; ++cycle) {
+      vtkNew<vtkRenderer> renderer;
+      renderer->SetBackground(0.1, 0.2, 0.4);
+      vtkNew<vtkGlfwOpenGLRenderWindow> window;
+      window->SetSize(320, 240);
+      window->SetUnfocusedFrameRate(0.0);
+      window->AddRenderer(renderer);
+      vtkGlfwTestCheck(window->GetGenericWindowId() == nullptr);
+
+      window->Render();
+      vtkGlfwTestCheck(window->GetGenericWindowId() != nullptr);
+      vtkGlfwTestCheck(window->GetActiveBackend() !=
+                       vtkGlfwOpenGLRenderWindow::BACKEND_AUTO);
+      vtkGlfwTestCheck(window->GetStartupTime() > 0.0);
+      if (cycle == 0) {
+        vtkGlfwTestBudget::Measure(
+          std::string("StartupTime") +
+            backendNames[window->GetActiveBackend()],
+          window->GetStartupTime());
+      }
+      for (int i = 1; i < frames; ++i) {
+        window->Render();
+      }
+      vtkGlfwTestCheck(window->GetNumberOfFrames() == frames);
+
+      // symmetric with Initialize(), and fine to call again
+      window->Finalize();
+      vtkGlfwTestCheck(window->GetGenericWindowId() == nullptr);
+      vtkGlfwTestCheck(window->GetActiveBackend() ==
+                       vtkGlfwOpenGLRenderWindow::BACKEND_AUTO);
+      window->Finalize();
+
+      const vtkIdType before = window->GetNumberOfFrames();
+      window->Render();
+      vtkGlfwTestCheck(window->GetGenericWindowId() != nullptr);
+      vtkGlfwTestCheck(window->GetNumberOfFrames() > before);
+      budget.AddFrames(window->GetNumberOfFrames());
+      // the window goes away with the context still current
+      window->MakeCurrent();
+    }
+    return EXIT_SUCCESS;
+  }();
+  return budget.Finish(result);
+}
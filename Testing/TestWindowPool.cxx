@@ -0,0 +1,157 @@
+#include "vtkCallbackCommand.h"
+#include "vtkCommand.h"
+#include "vtkNew.h"
+#include "vtkRenderer.h"
+#include "vtkRendererCollection.h"
+
+// clang-format off
+#include "vtkGlfwOpenGLRenderWindow.h"
+#include "vtkGlfwTestBudget.h"
+#include "vtkGlfwWindowPool.h"
+// clang-format on
+
+#include <GLFW/glfw3.h>
+
+#include <vector>
+
+namespace {
+struct FrameCapture
+{
+  int Frames = 0;
+  int Size[2] = { 0, 0 };
+  std::vector<unsigned char> Pixels;
+  bool Read = false;
+};
+
+void
+captureFrame(vtkObject* caller, unsigned long, void* clientData, void*)
+{
+  auto window = static_cast<vtkGlfwOpenGLRenderWindow*>(caller);
+  auto capture = static_cast<FrameCapture*>(clientData);
+  ++capture->Frames;
+  capture->Size[0] = window->GetSize()[0];
+  capture->Size[1] = window->GetSize()[1];
+  capture->Pixels.resize(size_t(capture->Size[0]) * capture->Size[1] * 4);
+  capture->Read = window->ReadFramePixels(capture->Pixels.data(), 4);
+}
+
+void
+countFrame(vtkObject*, unsigned long, void* clientData, void*)
+{
+  ++*static_cast<int*>(clientData);
+}
+
+// let the size callback catch up with the window system
+bool
+waitForFramebuffer(vtkGlfwOpenGLRenderWindow* window, int width, int height)
+{
+  const double deadline = glfwGetTime() + 2.0;
+  while (glfwGetTime() < deadline) {
+    const int* size = window->GetFramebufferSize();
+    // content scale may make the framebuffer larger, never smaller
+    if (size[0] >= width && size[1] >= height) {
+      return true;
+    }
+    glfwWaitEventsTimeout(0.01);
+  }
+  return false;
+}
+}
+
+// Run a series of jobs on pooled windows: one window has to serve them
+// all, come back without the previous job's renderers and observers but
+// with those of the window setup, render at each job's size, and be
+// destroyed once it has idled longer than IdleTimeout.
+int
+main(int argc, char* argv[])
+{
+  vtkGlfwTestBudget budget("TestWindowPool", argc, argv);
+  const int sizes[][2] = { { 64, 48 },  { 64, 48 }, { 160, 120 },
+                           { 160, 120 }, { 48, 96 }, { 64, 48 } };
+  const int framesPerJob = 5;
+
+  int setupFrames = 0;
+  vtkNew<vtkCallbackCommand> setupObserver;
+  setupObserver->SetCallback(countFrame);
+  setupObserver->SetClientData(&setupFrames);
+
+  vtkNew<vtkGlfwWindowPool> pool;
+  pool->SetIdleTimeout(-1.0);
+  pool->SetWindowSetup([&](vtkGlfwOpenGLRenderWindow* window) {
+    window->SetUnfocusedFrameRate(0.0);
+    window->AddObserver(vtkCommand::WindowFrameEvent, setupObserver);
+  });
+
+  std::vector<FrameCapture> captures(sizeof(sizes) / sizeof(sizes[0]));
+  int result = [&]() {
+    for (size_t job = 0; job < captures.size(); ++job) {
+      const int* size = sizes[job];
+      vtkGlfwOpenGLRenderWindow* window = pool->Acquire(size[0], size[1]);
+      vtkGlfwTestCheck(window != nullptr);
+      vtkGlfwTestCheck(pool->GetNumberOfWindowsCreated() == 1);
+      vtkGlfwTestCheck(pool->GetNumberOfReuses() == vtkIdType(job));
+      vtkGlfwTestCheck(pool->GetNumberOfActiveWindows() == 1);
+      vtkGlfwTestCheck(pool->GetNumberOfIdleWindows() == 0);
+      vtkGlfwTestCheck(window->GetRenderers()->GetNumberOfItems() == 0);
+      vtkGlfwTestCheck(window->GetSize()[0] == size[0]);
+      vtkGlfwTestCheck(window->GetSize()[1] == size[1]);
+      vtkGlfwTestCheck(waitForFramebuffer(window, size[0], size[1]));
+
+      vtkNew<vtkRenderer> renderer;
+      renderer->SetBackground(job % 2 ? 0.0 : 1.0, job % 2 ? 1.0 : 0.0, 0.0);
+      window->AddRenderer(renderer);
+      FrameCapture& capture = captures[job];
+      vtkNew<vtkCallbackCommand> observer;
+      observer->SetCallback(captureFrame);
+      observer->SetClientData(&capture);
+      window->AddObserver(vtkCommand::WindowFrameEvent, observer);
+
+      const int before = setupFrames;
+      for (int frame = 0; frame < framesPerJob; ++frame) {
+        window->Render();
+      }
+      // the setup observer stays, earlier jobs' observers are gone
+      vtkGlfwTestCheck(setupFrames == before + framesPerJob);
+      vtkGlfwTestCheck(capture.Frames == framesPerJob);
+      for (size_t earlier = 0; earlier < job; ++earlier) {
+        vtkGlfwTestCheck(captures[earlier].Frames == framesPerJob);
+      }
+
+      vtkGlfwTestCheck(capture.Read);
+      vtkGlfwTestCheck(capture.Size[0] == size[0]);
+      vtkGlfwTestCheck(capture.Size[1] == size[1]);
+      const unsigned char red = job % 2 ? 0 : 255;
+      const size_t last = capture.Pixels.size() - 4;
+      for (size_t offset : { size_t(0), last }) {
+        const unsigned char* pixel = capture.Pixels.data() + offset;
+        vtkGlfwTestCheck(pixel[0] == red && pixel[1] == 255 - red);
+      }
+
+      pool->Release(window);
+      vtkGlfwTestCheck(pool->GetNumberOfActiveWindows() == 0);
+      vtkGlfwTestCheck(pool->GetNumberOfIdleWindows() == 1);
+    }
+
+    // an idle window is kept until it times out
+    const double timeout = 0.2;
+    pool->SetIdleTimeout(timeout);
+    vtkGlfwTestCheck(pool->GetReclaimDelay() > 0.0);
+    vtkGlfwTestCheck(pool->ReclaimIdleWindows() == 0);
+    const double deadline = glfwGetTime() + 2.0;
+    while (pool->GetNumberOfIdleWindows() > 0 && glfwGetTime() < deadline) {
+      const double delay = pool->GetReclaimDelay();
+      vtkGlfwTestCheck(delay >= 0.0 && delay <= timeout);
+      if (delay > 0.0) {
+        glfwWaitEventsTimeout(delay);
+      }
+      pool->ReclaimIdleWindows();
+    }
+    vtkGlfwTestCheck(pool->GetNumberOfIdleWindows() == 0);
+    vtkGlfwTestCheck(pool->GetNumberOfWindowsReclaimed() == 1);
+    vtkGlfwTestCheck(pool->GetReclaimDelay() < 0.0);
+    vtkGlfwTestCheck(pool->GetNumberOfWindowsCreated() == 1);
+    return EXIT_SUCCESS;
+  }();
+  budget.AddFrames(setupFrames);
+  return budget.Finish(result);
+}
@@ -0,0 +1,104 @@
+#include "vtkCallbackCommand.h"
+#include "vtkCommand.h"
+#include "vtkNew.h"
+#include "vtkRenderer.h"
+
+// clang-format off
+#include "vtkGlfwOpenGLRenderWindow.h"
+#include "vtkGlfwTestBudget.h"
+// clang-format on
+
+#include <GLFW/glfw3.h>
+
+#include <vector>
+
+namespace {
+struct FrameCapture
+{
+  int Size[2] = { 0, 0 };
+  std::vector<unsigned char> Pixels;
+  bool Read = false;
+};
+
+void
+captureFrame(vtkObject* caller, unsigned long, void* clientData, void*)
+{
+  auto window = static_cast<vtkGlfwOpenGLRenderWindow*>(caller);
+  auto capture = static_cast<FrameCapture*>(clientData);
+  capture->Size[0] = window->GetSize()[0];
+  capture->Size[1] = window->GetSize()[1];
+  capture->Pixels.resize(size_t(capture->Size[0]) * capture->Size[1] * 4);
+  capture->Read = window->ReadFramePixels(capture->Pixels.data(), 4);
+}
+
+// let the size callback catch up with the window system
+bool
+waitForFramebuffer(vtkGlfwOpenGLRenderWindow* window, int width, int height)
+{
+  const double deadline = glfwGetTime() + 2.0;
+  while (glfwGetTime() < deadline) {
+    const int* size = window->GetFramebufferSize();
+    // content scale may make the framebuffer larger, never smaller
+    if (size[0] >= width && size[1] >= height) {
+      return true;
+    }
+    glfwWaitEventsTimeout(0.01);
+  }
+  return false;
+}
+}
+
+// Resize a window back and forth; each frame has to come out at the new
+// size, filled with the background.
+int
+main(int argc, char* argv[])
+{
+  vtkGlfwTestBudget budget("TestWindowResize", argc, argv);
+  const int sizes[][2] = { { 300, 200 }, { 640, 480 }, { 64, 64 },
+                           { 800, 300 }, { 200, 600 }, { 300, 200 } };
+  const int rounds = 5;
+
+  vtkNew<vtkRenderer> renderer;
+  renderer->SetBackground(1.0, 0.0, 0.0);
+  vtkNew<vtkGlfwOpenGLRenderWindow> window;
+  window->SetSize(sizes[0][0], sizes[0][1]);
+  window->SetUnfocusedFrameRate(0.0);
+  window->AddRenderer(renderer);
+
+  FrameCapture capture;
+  vtkNew<vtkCallbackCommand> observer;
+  observer->SetCallback(captureFrame);
+  observer->SetClientData(&capture);
+  window->AddObserver(vtkCommand::WindowFrameEvent, observer);
+
+  int result = [&]() {
+    window->Render();
+    vtkGlfwTestCheck(window->GetGenericWindowId() != nullptr);
+    for (int round = 0; round < rounds; ++round) {
+      for (const auto& size : sizes) {
+        // renders at the new size right away
+        window->SetSize(size[0], size[1]);
+        vtkGlfwTestCheck(window->GetSize()[0] == size[0]);
+        vtkGlfwTestCheck(window->GetSize()[1] == size[1]);
+        vtkGlfwTestCheck(waitForFramebuffer(window, size[0], size[1]));
+
+        capture.Read = false;
+        window->Render();
+        vtkGlfwTestCheck(capture.Read);
+        vtkGlfwTestCheck(capture.Size[0] == size[0]);
+        vtkGlfwTestCheck(capture.Size[1] == size[1]);
+        const int* viewport = renderer->GetSize();
+        vtkGlfwTestCheck(viewport[0] == size[0] && viewport[1] == size[1]);
+        // the corners are only drawn if the viewport followed the resize
+        const size_t last = capture.Pixels.size() - 4;
+        for (size_t offset : { size_t(0), last }) {
+          const unsigned char* pixel = capture.Pixels.data() + offset;
+          vtkGlfwTestCheck(pixel[0] == 255 && pixel[1] == 0 && pixel[2] == 0);
+        }
+      }
+    }
+    return EXIT_SUCCESS;
+  }();
+  budget.AddFrames(window->GetNumberOfFrames());
+  return budget.Finish(result);
+}
@@ -0,0 +1,133 @@
+#ifndef vtkGlfwTestBudget_h
+#define vtkGlfwTestBudget_h
+
+#include "vtkType.h"
+
+#include <algorithm> // for std::max
+#include <chrono>    // for std::chrono
+#include <cstdlib>   // for EXIT_SUCCESS
+#include <fstream>   // for std::ifstream
+#include <iostream>  // for std::cerr
+#include <sstream>   // for std::istringstream
+#include <string>    // for std::string
+
+/**
+ * Report a failed check with its location and fail the test.
+ */
+#define vtkGlfwTestCheck(condition)                                            \
+  do {                                                                         \
+    if (!(condition)) {                                                        \
+      std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: "           \
+                << #condition << "\n";                                         \
+      return EXIT_FAILURE;                                                     \
+    }                                                                          \
+  } while (0)
+
+/**
+ * Measures a test run and holds it to the test's line in the budget file
+ * given as the first command line argument:
+ *
+ *   name  seconds  frames-per-second  events-per-second
+ *
+ * i.e. the most wall time the run may take and the least frame and event
+ * throughput it has to reach, 0 for no limit. VTKGLFW_BUDGET_SCALE, e.g. 2
+ * on a slow machine, multiplies the time and divides the throughput
+ * limits. The measurements are printed for CTest to record with the test.
+ */
+class vtkGlfwTestBudget
+{
+public:
+  using Clock = std::chrono::steady_clock;
+
+  vtkGlfwTestBudget(const char* name, int argc, char* argv[])
+    : Name(name)
+    , BudgetFile(argc > 1 ? argv[1] : "")
+    , Start(Clock::now())
+  {}
+
+  void AddFrames(vtkIdType frames) { this->Frames += frames; }
+  void AddEvents(vtkIdType events) { this->Events += events; }
+
+  /**
+   * Print a value for CTest to record with the test, next to the ones
+   * Finish() prints.
+   */
+  static void Measure(const std::string& name, double value)
+  {
+    std::cout << "<DartMeasurement name=\"" << name
+              << "\" type=\"numeric/double\">" << value
+              << "</DartMeasurement>\n";
+  }
+
+  /**
+   * Record the run and return the test's exit code: failure if result
+   * is, or if the run is over budget.
+   */
+  int Finish(int result)
+  {
+    const double seconds =
+      std::chrono::duration<double>(Clock::now() - this->Start).count();
+    const double frameRate = seconds > 0.0 ? this->Frames / seconds : 0.0;
+    const double eventRate = seconds > 0.0 ? this->Events / seconds : 0.0;
+    Measure("WallTime", seconds);
+    Measure("Frames", static_cast<double>(this->Frames));
+    Measure("FramesPerSecond", frameRate);
+    Measure("Events", static_cast<double>(this->Events));
+    Measure("EventsPerSecond", eventRate);
+    if (result != EXIT_SUCCESS) {
+      return EXIT_FAILURE;
+    }
+
+    double maxSeconds = 0.0, minFrameRate = 0.0, minEventRate = 0.0;
+    if (!this->ReadBudget(maxSeconds, minFrameRate, minEventRate)) {
+      std::cerr << "No budget for " << this->Name << " in "
+                << this->BudgetFile << "\n";
+      return EXIT_FAILURE;
+    }
+    double scale = 1.0;
+    if (const char* env = std::getenv("VTKGLFW_BUDGET_SCALE")) {
+      scale = std::max(std::atof(env), 0.01);
+    }
+    bool within = true;
+    if (maxSeconds > 0.0 && seconds > maxSeconds * scale) {
+      std::cerr << this->Name << " took " << seconds << " s, budget is "
+                << maxSeconds * scale << " s\n";
+      within = false;
+    }
+    if (minFrameRate > 0.0 && frameRate < minFrameRate / scale) {
+      std::cerr << this->Name << " rendered " << frameRate
+                << " frames/s, budget is " << minFrameRate / scale << "\n";
+      within = false;
+    }
+    if (minEventRate > 0.0 && eventRate < minEventRate / scale) {
+      std::cerr << this->Name << " handled " << eventRate
+                << " events/s, budget is " << minEventRate / scale << "\n";
+      within = false;
+    }
+    return within ? EXIT_SUCCESS : EXIT_FAILURE;
+  }
+
+protected:
+
+  bool ReadBudget(double& seconds, double& frameRate, double& eventRate)
+  {
+    std::ifstream file(this->BudgetFile);
+    std::string line;
+    while (std::getline(file, line)) {
+      std::istringstream fields(line);
+      std::string name;
+      if (fields >> name && name == this->Name) {
+        return static_cast<bool>(fields >> seconds >> frameRate >> eventRate);
+      }
+    }
+    return false;
+  }
+
+  std::string Name;
+  std::string BudgetFile;
+  Clock::time_point Start;
+  vtkIdType Frames = 0;
+  vtkIdType Events = 0;
+};
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef vtkGlfwFrameStreamClient_h
+#define vtkGlfwFrameStreamClient_h
+
+#include "vtkObject.h"
+
+#include "vtkGlfwFrameStreamProtocol.h"
+
+#include <vector>
+
+/**
+ * Minimal viewer side of vtkGlfwFrameStreamer: receives encoded frames,
+ * acknowledges them and sends input back. Decoding and display are left to
+ * the application.
+ */
+class vtkGlfwFrameStreamClient : public vtkObject
+{
+public:
+  static vtkGlfwFrameStreamClient* New();
+  vtkTypeMacro(vtkGlfwFrameStreamClient, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  bool Connect(int port, const char* host = "127.0.0.1");
+  void Disconnect();
+  bool IsConnected() { return this->Socket >= 0; }
+
+  /**
+   * Wait up to timeout seconds for the next frame and acknowledge it.
+   * A negative timeout waits forever. Returns false on timeout or when the
+   * connection was lost.
+   */
+  bool ReceiveFrame(vtkGlfwFrameStream::FrameHeader& header,
+                    std::vector<unsigned char>& payload,
+                    double timeout = -1.0);
+
+  bool SendInput(const vtkGlfwFrameStream::InputMessage& message);
+
+protected:
+  vtkGlfwFrameStreamClient();
+  ~vtkGlfwFrameStreamClient() override;
+
+  int Socket;
+
+private:
+  vtkGlfwFrameStreamClient(const vtkGlfwFrameStreamClient&) = delete;
+  void operator=(const vtkGlfwFrameStreamClient&) = delete;
+};
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef vtkGlfwFrameStreamProtocol_h
+#define vtkGlfwFrameStreamProtocol_h
+
+#include <cstdint>
+
+/**
+ * Wire format shared by vtkGlfwFrameStreamer and vtkGlfwFrameStreamClient.
+ *
+ * The server sends a FrameHeader followed by PayloadSize bytes of encoded
+ * image for every frame that changed. The client answers each frame with a
+ * MESSAGE_ACK and may send input messages at any time. Fields are in the
+ * host's byte order; the endpoint only listens on the loopback interface.
+ */
+namespace vtkGlfwFrameStream {
+
+const uint32_t Magic = 0x53464756; // "VGFS"
+
+enum Formats : uint32_t
+{
+  FORMAT_JPEG = 1,
+  FORMAT_PNG = 2
+};
+
+struct FrameHeader
+{
+  uint32_t Magic;
+  uint32_t Sequence;
+  // size of the encoded image, i.e. after downscaling
+  uint32_t Width;
+  uint32_t Height;
+  // the window is Downscale times larger than the encoded image
+  uint32_t Downscale;
+  uint32_t Format;
+  uint32_t PayloadSize;
+  uint32_t Reserved;
+};
+
+enum MessageTypes : int32_t
+{
+  MESSAGE_ACK = 0,
+  MESSAGE_MOUSE_MOVE,
+  MESSAGE_MOUSE_BUTTON,
+  MESSAGE_SCROLL,
+  MESSAGE_KEY,
+  MESSAGE_CHAR
+};
+
+/**
+ * Input sent back by the client. Positions are in window pixels with the
+ * origin at the top left, i.e. image coordinates times Downscale. Button,
+ * Action, Key and Mods use GLFW's values.
+ */
+struct InputMessage
+{
+  int32_t Type;
+  // frame acknowledged by MESSAGE_ACK
+  uint32_t Sequence;
+  int32_t X;
+  int32_t Y;
+  int32_t Button;
+  int32_t Action;
+  int32_t Key;
+  int32_t Mods;
+  // scroll direction, positive is forward
+  int32_t Delta;
+  uint32_t Codepoint;
+  char KeySym[16];
+};
+
+}
+
+#endif
@@ -0,0 +1,141 @@
+#ifndef vtkGlfwFrameStreamer_h
+#define vtkGlfwFrameStreamer_h
+
+#include "vtkObject.h"
+
+class vtkGlfwOpenGLRenderWindow;
+class vtkGlfwRenderWindowInteractor;
+
+/**
+ * Serves the frames of a vtkGlfwOpenGLRenderWindow to a viewer in another
+ * process over a loopback TCP socket.
+ *
+ * The streamer observes the window's WindowFrameEvent, reads each finished
+ * frame back and hands it to worker threads that skip frames identical to
+ * the last one sent, downscale and encode them as JPEG or PNG. Frames are
+ * sent only while a client is connected. The client acknowledges every
+ * frame; when it falls more than a few frames behind, the resolution is
+ * halved, and it is doubled again once the client keeps up. Input messages
+ * from the client are injected into the interactor, if one is set. See
+ * vtkGlfwFrameStreamProtocol.h for the wire format and
+ * vtkGlfwFrameStreamClient for a matching client. POSIX sockets only.
+ */
+class vtkGlfwFrameStreamer : public vtkObject
+{
+public:
+  static vtkGlfwFrameStreamer* New();
+  vtkTypeMacro(vtkGlfwFrameStreamer, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  //@{
+  /**
+   * The window whose frames are streamed.
+   */
+  void SetRenderWindow(vtkGlfwOpenGLRenderWindow* window);
+  vtkGetObjectMacro(RenderWindow, vtkGlfwOpenGLRenderWindow);
+  //@}
+
+  //@{
+  /**
+   * Interactor receiving the client's input, may be nullptr.
+   */
+  void SetInteractor(vtkGlfwRenderWindowInteractor* iren);
+  vtkGetObjectMacro(Interactor, vtkGlfwRenderWindowInteractor);
+  //@}
+
+  /**
+   * Listen on 127.0.0.1:port, port 0 picks a free one. Returns false if the
+   * socket could not be set up.
+   */
+  bool Start(int port = 0);
+
+  /**
+   * Disconnect the client and stop listening.
+   */
+  void Stop();
+
+  /**
+   * The port being listened on, or 0 when not started.
+   */
+  int GetPort();
+
+  bool IsClientConnected();
+
+  enum Formats
+  {
+    FORMAT_JPEG = 1,
+    FORMAT_PNG = 2
+  };
+
+  //@{
+  /**
+   * Encoding of the streamed frames. Default is JPEG.
+   */
+  vtkSetClampMacro(Format, int, FORMAT_JPEG, FORMAT_PNG);
+  vtkGetMacro(Format, int);
+  void SetFormatToJPEG() { this->SetFormat(FORMAT_JPEG); }
+  void SetFormatToPNG() { this->SetFormat(FORMAT_PNG); }
+  //@}
+
+  //@{
+  /**
+   * JPEG quality, 1 to 100. Default is 80.
+   */
+  vtkSetClampMacro(Quality, int, 1, 100);
+  vtkGetMacro(Quality, int);
+  //@}
+
+  //@{
+  /**
+   * Number of encoding threads, read by Start(). Default is 2.
+   */
+  vtkSetClampMacro(EncoderThreads, int, 1, 64);
+  vtkGetMacro(EncoderThreads, int);
+  //@}
+
+  //@{
+  /**
+   * Largest downscale factor used for a slow client, a power of two.
+   * Default is 8.
+   */
+  vtkSetClampMacro(MaximumDownscale, int, 1, 64);
+  vtkGetMacro(MaximumDownscale, int);
+  //@}
+
+  /**
+   * Current downscale factor.
+   */
+  int GetDownscale();
+
+  //@{
+  /**
+   * Frame statistics since Start().
+   */
+  vtkIdType GetNumberOfFramesSent();
+  vtkIdType GetNumberOfFramesUnchanged();
+  vtkIdType GetNumberOfFramesDropped();
+  //@}
+
+protected:
+  vtkGlfwFrameStreamer();
+  ~vtkGlfwFrameStreamer() override;
+
+  void OnFrame(vtkObject* caller, unsigned long event, void* callData);
+
+  vtkGlfwOpenGLRenderWindow* RenderWindow;
+  vtkGlfwRenderWindowInteractor* Interactor;
+  unsigned long FrameObserver;
+  int Format;
+  int Quality;
+  int EncoderThreads;
+  int MaximumDownscale;
+
+  class vtkInternals;
+  vtkInternals* Internals;
+
+private:
+  vtkGlfwFrameStreamer(const vtkGlfwFrameStreamer&) = delete;
+  void operator=(const vtkGlfwFrameStreamer&) = delete;
+};
+
+#endif
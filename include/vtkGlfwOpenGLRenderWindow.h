@@ -3,8 +3,15 @@
 
 #include "vtkOpenGLRenderWindow.h"
 #include <GLFW/glfw3.h> // for ivars
+#include <functional>   // for std::function
 #include <stack>        // for ivar
 
+class vtkGlfwPerformanceHud;
+class vtkGlfwPixelReadback;
+class vtkGlfwShaderBinaryCache;
+class vtkGlfwSnapshotWriter;
+class vtkGlfwUploadContext;
+
 class vtkGlfwOpenGLRenderWindow : public vtkOpenGLRenderWindow
 {
 public:
@@ -20,6 +27,40 @@ public:
    */
   void Initialize(void) override;
 
+  enum Backends
+  {
+    BACKEND_AUTO = 0,
+    BACKEND_DISPLAY,
+    BACKEND_EGL,
+    BACKEND_OSMESA
+  };
+
+  //@{
+  /**
+   * How Initialize() gets an OpenGL context. BACKEND_DISPLAY opens a window
+   * on the desktop. BACKEND_EGL and BACKEND_OSMESA need no display server:
+   * with GLFW 3.4 they run on GLFW's null platform and render into the
+   * offscreen buffers, read back with ReadFramePixels() or SaveSnapshot().
+   * BACKEND_AUTO, the default, takes the VTKGLFW_BACKEND environment
+   * variable (display, egl or osmesa) if set, else prefers the display when
+   * one is available and EGL otherwise. A backend that fails falls back to
+   * the others. Set before Initialize().
+   */
+  vtkSetClampMacro(Backend, int, BACKEND_AUTO, BACKEND_OSMESA);
+  vtkGetMacro(Backend, int);
+  //@}
+
+  /**
+   * The backend in use, BACKEND_AUTO while there is no window.
+   */
+  vtkGetMacro(ActiveBackend, int);
+
+  /**
+   * Seconds the first Initialize() took, from glfwInit() to the end of
+   * OpenGL initialization, to compare the cold start of backends.
+   */
+  vtkGetMacro(StartupTime, double);
+
   /**
    * Finalize the rendering window.  This will shutdown all system-specific
    * resources.  After having called this, it should be possible to destroy
@@ -28,10 +69,57 @@ public:
   void Finalize(void) override;
 
   /**
-   * Change the window to fill the entire screen.
+   * Change the window to fill the entire screen. May be called before the
+   * window exists; it then opens in full screen. Switching in either
+   * direction keeps the OpenGL context and all GPU resources.
    */
   void SetFullScreen(vtkTypeBool) override;
 
+  enum FullScreenModes
+  {
+    FULLSCREEN_EXCLUSIVE = 0,
+    FULLSCREEN_BORDERLESS = 1
+  };
+
+  //@{
+  /**
+   * How full screen is achieved. Exclusive mode makes the window the owner
+   * of the monitor at the selected video mode and bypasses the compositor.
+   * Borderless mode covers the monitor with an undecorated window at the
+   * desktop video mode. Changing this while in full screen switches
+   * immediately. Default is exclusive.
+   */
+  virtual void SetFullScreenMode(int mode);
+  vtkGetMacro(FullScreenMode, int);
+  void SetFullScreenModeToExclusive()
+  {
+    this->SetFullScreenMode(FULLSCREEN_EXCLUSIVE);
+  }
+  void SetFullScreenModeToBorderless()
+  {
+    this->SetFullScreenMode(FULLSCREEN_BORDERLESS);
+  }
+  //@}
+
+  //@{
+  /**
+   * Index into glfwGetMonitors() of the monitor to go full screen on. A
+   * negative value, the default, picks the monitor the window is on.
+   */
+  virtual void SetFullScreenMonitor(int index);
+  vtkGetMacro(FullScreenMonitor, int);
+  //@}
+
+  //@{
+  /**
+   * Video mode requested for exclusive full screen. The closest mode the
+   * monitor supports is used, matching resolution first and refresh rate
+   * second. Zero for any value keeps the monitor's current setting.
+   */
+  virtual void SetFullScreenVideoMode(int width, int height, int refreshRate);
+  vtkGetVector3Macro(FullScreenVideoMode, int);
+  //@}
+
   /**
    * Show or not Show the window
    */
@@ -46,10 +134,23 @@ public:
   //@}
 
   /**
-   * Get the current size of the window in pixels.
+   * Get the current size of the window in screen coordinates. This and the
+   * other geometry getters read a cache maintained by GLFW callbacks.
    */
   int* GetSize() VTK_SIZEHINT(2) override;
 
+  /**
+   * Get the size of the window's framebuffer in pixels. It differs from
+   * GetSize() on displays with a content scale.
+   */
+  vtkGetVector2Macro(FramebufferSize, int);
+
+  /**
+   * Get the content scale of the window, i.e. the ratio between the
+   * current DPI and the platform's default DPI.
+   */
+  vtkGetVector2Macro(ContentScale, float);
+
   //@{
   /**
    * Set the position of the window.
@@ -59,7 +160,7 @@ public:
   //@}
 
   /**
-   * Get the current size of the screen in pixels.
+   * Get the size in pixels of the screen the window is on.
    */
   int* GetScreenSize() VTK_SIZEHINT(2) override;
 
@@ -96,9 +197,74 @@ public:
   /**
    * A termination method performed at the end of the rendering process
    * to do things like swapping buffers (if necessary) or similar actions.
+   * Unless the render was aborted, vtkCommand::WindowFrameEvent is invoked
+   * right before the swap, while the finished frame can still be read.
    */
   void Frame() override;
 
+  /**
+   * Begin a frame, starting the GPU timer of the performance HUD if it is
+   * shown.
+   */
+  void Start() override;
+
+  /**
+   * Read the finished frame, Size[0] x Size[1] pixels with 3 (RGB) or 4
+   * (RGBA) 8 bit components, into data in OpenGL row order (bottom row
+   * first). Meant for WindowFrameEvent observers. Returns false if there
+   * is no window or components is not 3 or 4.
+   */
+  bool ReadFramePixels(unsigned char* data, int components);
+
+  /**
+   * Read the depth buffer of the finished frame, Size[0] x Size[1] window
+   * depths in [0, 1], into data in OpenGL row order. Meant for
+   * WindowFrameEvent observers. Returns false if there is no window.
+   */
+  bool ReadFrameDepth(float* data);
+
+  /**
+   * A finished frame read back without stalling, see StartFrameReadback().
+   */
+  struct FramePixels
+  {
+    int Width = 0;
+    int Height = 0;
+    // RGBA, bottom row first
+    const unsigned char* Color = nullptr;
+    // window depths, bottom row first, nullptr unless requested
+    const float* Depth = nullptr;
+  };
+
+  /**
+   * Read the finished frame like ReadFramePixels() and, with depth,
+   * ReadFrameDepth(), but through pixel pack buffers: the copy is only
+   * queued, and mapped with MapFrameReadback() once the GPU is done,
+   * typically a frame later. Up to three frames can be in flight. Returns
+   * false when they all are, or there is no window. Meant for a single
+   * WindowFrameEvent observer per window.
+   */
+  bool StartFrameReadback(bool depth);
+
+  /**
+   * Map the oldest frame from StartFrameReadback(). Unless wait is set,
+   * returns false while the GPU has not finished it; also false if there
+   * is none, or it could not be mapped, in which case it is dropped. The
+   * pixels stay valid until FinishFrameReadback().
+   */
+  bool MapFrameReadback(FramePixels& pixels, bool wait);
+
+  /**
+   * Drop the oldest frame from StartFrameReadback(), mapped or not.
+   */
+  void FinishFrameReadback();
+
+  /**
+   * Frames started with StartFrameReadback() and not finished. Releasing
+   * the window's graphics resources drops them.
+   */
+  int GetNumberOfFrameReadbacks();
+
   //@{
   /**
    * Ability to push and pop this window's context
@@ -137,6 +303,291 @@ public:
   void ShowCursor() override;
   //@}
 
+  /**
+   * Receives the rows of a tiled render, top row first. Each row is
+   * `width` tightly packed RGBA pixels. Return false to abort the render.
+   */
+  using TileRowWriter = std::function<bool(int row, const unsigned char* rgba)>;
+
+  /**
+   * Render an image of width x height pixels as a grid of camera-offset
+   * tiles and stream it to writer one row at a time. The image may exceed
+   * both the screen and GL_MAX_VIEWPORT_DIMS. Tiles are rendered into the
+   * offscreen buffers and read back asynchronously while the next tile
+   * renders; only one band of tiles is ever held in memory. Renderer
+   * viewports, aspects and camera centers come out as in a width x height
+   * window. Tiles are not counted in NumberOfFrames and do not invoke
+   * WindowFrameEvent. Returns false on failure or when the writer aborts.
+   */
+  bool RenderTiled(int width, int height, const TileRowWriter& writer);
+
+  //@{
+  /**
+   * Upper bound on the edge length of a single tile used by RenderTiled().
+   * The effective value is also clamped to GL_MAX_VIEWPORT_DIMS.
+   * Default is 2048.
+   */
+  vtkSetClampMacro(MaximumTileSize, int, 16, VTK_INT_MAX);
+  vtkGetMacro(MaximumTileSize, int);
+  //@}
+
+  //@{
+  /**
+   * Handlers for the GLFW window geometry callbacks installed when the
+   * window is created. They update the cached geometry and forward
+   * resizes to a vtkGlfwRenderWindowInteractor.
+   */
+  virtual void OnSize(int w, int h);
+  virtual void OnPosition(int x, int y);
+  virtual void OnFramebufferSize(int w, int h);
+  virtual void OnContentScale(float xs, float ys);
+  //@}
+
+  //@{
+  /**
+   * Handlers for the GLFW focus, iconify and refresh callbacks. Focus and
+   * iconify state drive render throttling; a refresh redraws the window
+   * only when the system has lost its contents.
+   */
+  virtual void OnFocus(int focused);
+  virtual void OnIconify(int iconified);
+  virtual void OnRefresh();
+  //@}
+
+  //@{
+  /**
+   * Window state as last reported by GLFW.
+   */
+  vtkGetMacro(Focused, bool);
+  vtkGetMacro(Iconified, bool);
+  //@}
+
+  /**
+   * Render unless throttled. While the window is iconified, or shown
+   * without input focus faster than UnfocusedFrameRate, the render is
+   * skipped and remembered for RenderDeferred().
+   */
+  void Render() override;
+
+  //@{
+  /**
+   * Skip rendering while the window is iconified. Default is on.
+   */
+  vtkSetMacro(PauseWhenIconified, bool);
+  vtkGetMacro(PauseWhenIconified, bool);
+  vtkBooleanMacro(PauseWhenIconified, bool);
+  //@}
+
+  //@{
+  /**
+   * Frame rate cap while the window is shown without input focus, 0 for
+   * none. Hidden windows are never capped. Default is 10.
+   */
+  vtkSetClampMacro(UnfocusedFrameRate, double, 0.0, VTK_DOUBLE_MAX);
+  vtkGetMacro(UnfocusedFrameRate, double);
+  //@}
+
+  //@{
+  /**
+   * Feed measured frame times, swap included, back into the renderers'
+   * allocated render time, so LOD props hold DesiredUpdateRate even when
+   * swap, readback or overlays cost more than the props estimate. With a
+   * vtkGlfwRenderWindowInteractor the rate also follows interaction: the
+   * interactor's DesiredUpdateRate while input arrives, StillUpdateRate
+   * once it stops. Default is off.
+   */
+  vtkSetMacro(FrameTimeGovernor, bool);
+  vtkGetMacro(FrameTimeGovernor, bool);
+  vtkBooleanMacro(FrameTimeGovernor, bool);
+  //@}
+
+  //@{
+  /**
+   * Weight of the newest frame in the smoothed frame time. Lower values
+   * react slower but keep LOD choices from flickering. Default is 0.25.
+   */
+  vtkSetClampMacro(FrameTimeSmoothing, double, 0.01, 1.0);
+  vtkGetMacro(FrameTimeSmoothing, double);
+  //@}
+
+  //@{
+  /**
+   * Frames finished, i.e. Frame() calls outside RenderTiled() that were
+   * not aborted, and MakeCurrent()/PopContext() calls that actually
+   * switched the current context, since the window was created.
+   */
+  vtkGetMacro(NumberOfFrames, vtkIdType);
+  vtkGetMacro(NumberOfContextSwitches, vtkIdType);
+  //@}
+
+  //@{
+  /**
+   * Seconds from Render() to the end of the swap, for the last frame and
+   * smoothed over recent frames. Aborted renders are not counted.
+   */
+  vtkGetMacro(LastFrameTime, double);
+  vtkGetMacro(SmoothedFrameTime, double);
+  //@}
+
+  /**
+   * Seconds a render has to wait because of throttling: 0 if it would run
+   * now, -1 if rendering is paused.
+   */
+  double GetThrottleDelay();
+
+  /**
+   * Seconds until a render skipped by throttling may run: 0 if it may run
+   * now, -1 if none is pending or rendering is paused. The
+   * vtkGlfwRenderWindowInteractor event loop sleeps this long at most.
+   */
+  double GetDeferredRenderDelay();
+
+  /**
+   * Run a render skipped by throttling if it is due. Returns true if it
+   * rendered.
+   */
+  bool RenderDeferred();
+
+  //@{
+  /**
+   * Seconds a window may sit hidden or iconified, without rendering,
+   * before TrimResources() releases its graphics resources. Negative
+   * disables trimming. The vtkGlfwRenderWindowInteractor event loop trims
+   * when due. Default is -1.
+   */
+  vtkSetMacro(TrimDelay, double);
+  vtkGetMacro(TrimDelay, double);
+  //@}
+
+  /**
+   * Release the VBOs, textures, shaders and framebuffers of all renderers
+   * while keeping the window and its context open. Everything is created
+   * again by the next render, which showing or restoring the window
+   * triggers. Returns the video memory reclaimed in KiB, as far as the
+   * driver reports it through GL_NVX_gpu_memory_info or GL_ATI_meminfo,
+   * and 0 otherwise.
+   */
+  vtkIdType TrimResources();
+
+  /**
+   * Seconds until TrimDelay runs out: 0 if the window is due for trimming,
+   * -1 if it is shown, already trimmed or trimming is disabled.
+   */
+  double GetTrimResourcesDelay();
+
+  /**
+   * Trim the window if it is due. Returns true if it trimmed.
+   */
+  bool TrimResourcesIfDue();
+
+  //@{
+  /**
+   * Whether the graphics resources are released, and the video memory in
+   * KiB the last TrimResources() reclaimed.
+   */
+  vtkGetMacro(Trimmed, bool);
+  vtkGetMacro(ReclaimedMemory, vtkIdType);
+  //@}
+
+  /**
+   * Save the last rendered frame to fileName as a PNG. The frame is read
+   * back straight into a pooled buffer; encoding and writing happen on a
+   * worker pool, so the calling thread only pays for the readback. Blocks
+   * only when MaximumPendingSnapshots are still being written. Returns
+   * false if there is no frame to read.
+   */
+  bool SaveSnapshot(const char* fileName);
+
+  /**
+   * Block until all snapshots queued by SaveSnapshot() are on disk.
+   */
+  void WaitForSnapshots();
+
+  //@{
+  /**
+   * Number of threads encoding snapshots. Takes effect when the first
+   * snapshot is saved. Default is 2.
+   */
+  vtkSetClampMacro(SnapshotThreads, int, 1, 64);
+  vtkGetMacro(SnapshotThreads, int);
+  //@}
+
+  //@{
+  /**
+   * Number of snapshots that may wait for encoding before SaveSnapshot()
+   * blocks. Takes effect when the first snapshot is saved. Default is 8.
+   */
+  vtkSetClampMacro(MaximumPendingSnapshots, int, 1, 1024);
+  vtkGetMacro(MaximumPendingSnapshots, int);
+  //@}
+
+  //@{
+  /**
+   * zlib compression level used for snapshots, 0 to 9. Default is 3, which
+   * favors throughput over file size.
+   */
+  vtkSetClampMacro(SnapshotCompressionLevel, int, 0, 9);
+  vtkGetMacro(SnapshotCompressionLevel, int);
+  //@}
+
+  /**
+   * The shader cache, which keeps program binaries on disk once it has a
+   * directory to keep them in, see vtkGlfwShaderBinaryCache.
+   */
+  vtkGlfwShaderBinaryCache* GetShaderBinaryCache();
+
+  //@{
+  /**
+   * Have Initialize() link the programs the shader cache recorded in
+   * earlier runs on the upload context's thread, so they are ready before
+   * the mappers first ask for them. Needs a shader cache directory.
+   * Default is off.
+   */
+  vtkSetMacro(WarmUpShaders, bool);
+  vtkGetMacro(WarmUpShaders, bool);
+  vtkBooleanMacro(WarmUpShaders, bool);
+  //@}
+
+  //@{
+  /**
+   * Most programs linked ahead by WarmUpShaders, the most recently used
+   * first. Default is 64.
+   */
+  vtkSetClampMacro(MaximumWarmUpPrograms, int, 0, VTK_INT_MAX);
+  vtkGetMacro(MaximumWarmUpPrograms, int);
+  //@}
+
+  //@{
+  /**
+   * Overlay frame rate, CPU and GPU frame time, event and context switch
+   * rates and a graph of recent frame times in the top left corner. It is
+   * drawn onto the screen right before the swap, so snapshots and
+   * WindowFrameEvent observers never see it, and it is skipped for
+   * offscreen and display-less windows. The GPU time needs desktop
+   * OpenGL. vtkGlfwRenderWindowInteractor toggles it with
+   * PerformanceHudKey. Default is off.
+   */
+  vtkSetMacro(ShowPerformanceHud, bool);
+  vtkGetMacro(ShowPerformanceHud, bool);
+  vtkBooleanMacro(ShowPerformanceHud, bool);
+  void TogglePerformanceHud();
+  //@}
+
+  /**
+   * Create a hidden window whose context shares objects with this one,
+   * passing this window as the share argument of glfwCreateWindow just as
+   * CreateAWindow() does with the parent id. The caller owns the result
+   * and must destroy it with glfwDestroyWindow() on this thread.
+   */
+  GLFWwindow* CreateSharedContextWindow();
+
+  /**
+   * Get the background uploader for this window, starting it on first
+   * use. The uploader streams buffers and textures from its own thread and
+   * shared context. Returns nullptr before the window is initialized.
+   */
+  vtkGlfwUploadContext* GetUploadContext();
+
 protected:
   vtkGlfwOpenGLRenderWindow();
   ~vtkGlfwOpenGLRenderWindow() override;
@@ -146,12 +597,91 @@ protected:
   std::stack<GLFWwindow*> ContextStack;
   std::stack<GLFWwindow*> WindowStack;
   int ScreenSize[2];
+  int MaximumTileSize;
+  bool RenderingTiles;
+  vtkGlfwUploadContext* UploadContext;
+  int FullScreenMode;
+  int FullScreenMonitor;
+  int FullScreenVideoMode[3];
+  int WindowedGeometry[4];
+  bool BorderlessActive;
+  int FramebufferSize[2];
+  float ContentScale[2];
+  vtkGlfwSnapshotWriter* SnapshotWriter;
+  int SnapshotThreads;
+  int MaximumPendingSnapshots;
+  int SnapshotCompressionLevel;
+  bool Focused;
+  bool Iconified;
+  bool PauseWhenIconified;
+  double UnfocusedFrameRate;
+  bool DeferredRender;
+  double LastRenderTime;
+  bool FrameTimeGovernor;
+  double FrameTimeSmoothing;
+  double LastFrameTime;
+  double SmoothedFrameTime;
+  double SmoothedFrameOverhead;
+  vtkIdType NumberOfFrames;
+  vtkIdType NumberOfContextSwitches;
+  int Backend;
+  int ActiveBackend;
+  double StartupTime;
+  double TrimDelay;
+  double HiddenSince;
+  bool Trimmed;
+  vtkIdType ReclaimedMemory;
+  bool WarmUpShaders;
+  int MaximumWarmUpPrograms;
+  bool ShowPerformanceHud;
+  vtkGlfwPerformanceHud* PerformanceHud;
+  vtkGlfwPixelReadback* PixelReadback;
   static const std::string DEFAULT_BASE_WINDOW_NAME;
 
   void CleanUpRenderers();
+
+  /**
+   * Initialize GLFW for backend and create the window with it. Returns
+   * false, leaving no window, if either fails.
+   */
+  bool TryBackend(int backend);
+
+  /**
+   * Set the GLFW context hints every context of this window is created
+   * with: client API, version, profile and the creation API of backend.
+   */
+  void SetContextHints(int backend);
   void CreateAWindow() override;
   void DestroyWindow() override;
 
+  /**
+   * Bind the framebuffer holding the last finished frame for reading.
+   * Callers must bracket this with Push/PopReadFramebufferBinding.
+   */
+  void BindFrameReadBuffer();
+
+  /**
+   * Bring the GLFW window in line with FullScreen and the full screen
+   * settings. Does nothing until the window exists.
+   */
+  void ApplyFullScreen();
+  GLFWmonitor* FindFullScreenMonitor();
+  GLFWmonitor* FindWindowMonitor();
+  void UpdateScreenInfo();
+  const GLFWvidmode* FindFullScreenVideoMode(GLFWmonitor* mon);
+
+  /**
+   * Record a frame time and, with the governor on, rebalance the
+   * renderers' allocated render time.
+   */
+  void UpdateFrameTime(double seconds);
+
+  /**
+   * Draw the performance HUD into the back buffer. Called by Frame()
+   * right before the swap.
+   */
+  void DrawPerformanceHud();
+
 private:
   vtkGlfwOpenGLRenderWindow(const vtkGlfwOpenGLRenderWindow&) = delete;
   void operator=(const vtkGlfwOpenGLRenderWindow&) = delete;
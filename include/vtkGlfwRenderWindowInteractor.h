@@ -3,6 +3,7 @@
 
 #include "vtkRenderWindowInteractor.h"
 #include <GLFW/glfw3.h>
+#include <functional> // for std::function
 
 class vtkGlfwRenderWindowInteractor
   : public vtkRenderWindowInteractor
@@ -40,6 +41,46 @@ public:
    */
   void ProcessEvents() override;
 
+  /**
+   * One iteration of StartEventLoop(): sleep until an event arrives or
+   * something is due, but no longer than timeout seconds unless it is
+   * negative, then handle everything pending. Lets a host loop (asio,
+   * epoll, Python) drive the interactor without polling. Returns false
+   * once the loop should end.
+   */
+  bool WaitAndProcessEvents(double timeout = -1.0);
+
+  /**
+   * Seconds the event loop may sleep before a timer, task, render or
+   * refinement pass is due, -1 to wait for the next event. A host loop
+   * can use it as the timeout of its own wait.
+   */
+  double GetEventTimeout();
+
+  /**
+   * Work to be run on the event loop's thread.
+   */
+  using Task = std::function<void()>;
+
+  /**
+   * Queue task to run in the next event loop iteration and wake the loop.
+   * Safe to call from any thread. Tasks run in the order posted; tasks
+   * posted by a running task wait for the next iteration.
+   */
+  void PostTask(Task task);
+
+  /**
+   * Ask for a render in the next event loop iteration and wake the loop.
+   * Safe to call from any thread; requests made before the render runs
+   * are merged into one.
+   */
+  void RequestRender();
+
+  /**
+   * Tasks posted and not run yet.
+   */
+  int GetNumberOfPendingTasks();
+
   /**
    * SDL2 specific application terminate, calls ClassExitMethod then
    * calls PostQuitMessage(0) to terminate the application. An application can
@@ -54,6 +95,110 @@ public:
    */
   void ExitCallback() override;
 
+  /**
+   * An input event that did not come from GLFW, e.g. one sent by a remote
+   * viewer. Positions are in window coordinates with the origin at the top
+   * left, like GLFW's; button, action, key and mods use GLFW's values.
+   */
+  struct InjectedEvent
+  {
+    enum Types
+    {
+      MOUSE_MOVE,
+      MOUSE_BUTTON,
+      SCROLL,
+      KEY,
+      CHAR
+    };
+    int Type = MOUSE_MOVE;
+    double X = 0;
+    double Y = 0;
+    int Button = 0;
+    int Action = 0;
+    int Key = 0;
+    // platform scancode of a KEY event, 0 if unknown
+    int Scancode = 0;
+    int Mods = 0;
+    double Delta = 0;
+    unsigned int Codepoint = 0;
+    char KeySym[16] = {};
+  };
+
+  /**
+   * Queue an event to be dispatched by the next ProcessEvents() as if GLFW
+   * had reported it. Safe to call from any thread; wakes a waiting loop.
+   */
+  void InjectEvent(const InjectedEvent& event);
+
+  //@{
+  /**
+   * Number of refinement passes rendered while the event loop is idle, 0
+   * to disable refinement. Default is 0.
+   */
+  vtkSetClampMacro(MaximumRefinementPasses, int, 0, VTK_INT_MAX);
+  vtkGetMacro(MaximumRefinementPasses, int);
+  //@}
+
+  /**
+   * Called with the pass number before each refinement render, so the
+   * application can raise sample counts or accumulate. Return false once
+   * the image has converged to stop refining. Called with 0 when input
+   * interrupts refinement, to go back to interactive quality before the
+   * input is handled.
+   */
+  using RefinementCallback = std::function<bool(int pass)>;
+  void SetRefinementCallback(const RefinementCallback& callback);
+
+  /**
+   * Refinement passes rendered since the last input.
+   */
+  vtkGetMacro(RefinementPass, int);
+
+  /**
+   * True while refinement passes remain to be rendered.
+   */
+  bool IsRefinementPending();
+
+  //@{
+  /**
+   * Relative mouse motion for fly-through navigation. The cursor is hidden
+   * and locked to the window, and GLFW_RAW_MOUSE_MOTION bypasses pointer
+   * acceleration where the platform supports it. Motion is coalesced into
+   * at most one MouseMoveEvent per event loop iteration whose callData is
+   * the double[2] delta, y up. The event position moves by the same delta
+   * without flipping or clamping to the window. Default is off.
+   */
+  virtual void SetRawMouseMotion(bool raw);
+  vtkGetMacro(RawMouseMotion, bool);
+  vtkBooleanMacro(RawMouseMotion, bool);
+  //@}
+
+  //@{
+  /**
+   * Key that toggles the window's performance HUD, e.g. GLFW_KEY_F3. Its
+   * presses go to the HUD instead of the interactor style, in order with
+   * the other input. Default is GLFW_KEY_UNKNOWN, which leaves every key
+   * to the style.
+   */
+  vtkSetMacro(PerformanceHudKey, int);
+  vtkGetMacro(PerformanceHudKey, int);
+  //@}
+
+  /**
+   * Input events handled so far, from GLFW or injected.
+   */
+  vtkGetMacro(NumberOfEvents, vtkIdType);
+
+  //@{
+  /**
+   * With the window's FrameTimeGovernor on, seconds without button, wheel
+   * or key input after which interaction counts as ended and the window
+   * goes back to StillUpdateRate. Default is 0.25.
+   */
+  vtkSetClampMacro(InteractionEndDelay, double, 0.0, 60.0);
+  vtkGetMacro(InteractionEndDelay, double);
+  //@}
+
   virtual int OnChar(GLFWwindow* wnd, unsigned int codepoint);
   virtual int OnDrop(GLFWwindow* wnd, int count, const char** paths);
   virtual int OnEnter(GLFWwindow* wnd, int entered);
@@ -65,6 +210,11 @@ public:
                      int scancode,
                      int action,
                      int mods);
+
+  /**
+   * Called by vtkGlfwOpenGLRenderWindow, which owns the GLFW size callback,
+   * after it has updated its cached size.
+   */
   virtual int OnSize(GLFWwindow* wnd, int w, int h);
 
 protected:
@@ -73,10 +223,99 @@ protected:
 
   bool InstallCallbacks;
   bool MouseInWindow;
+  int MaximumRefinementPasses;
+  int RefinementPass;
+  bool RefinementConverged;
+  double InteractionEndDelay;
+  vtkIdType NumberOfEvents;
+  bool RawMouseMotion;
+  int PerformanceHudKey;
+
+  class vtkInternals;
+  vtkInternals* Internals;
+
+  /**
+   * Dispatch the events queued by InjectEvent().
+   */
+  void DispatchInjectedEvents();
+
+  /**
+   * Work done after GLFW has processed its events: injected events, posted
+   * tasks, due timers, requested renders and renders deferred by the
+   * window's throttling.
+   */
+  void DispatchPendingEvents();
+
+  /**
+   * Run the tasks posted so far.
+   */
+  void RunPostedTasks();
+
+  /**
+   * Invoke TimerEvent for every timer that is due.
+   */
+  void FireTimers();
+
+  /**
+   * Record that input arrived, restarting refinement.
+   */
+  void NoteInput();
+
+  /**
+   * Toggle the performance HUD if key is PerformanceHudKey being pressed
+   * and the window has one. Returns whether the key was used up.
+   */
+  bool HandlePerformanceHudKey(int key, int action);
+
+  /**
+   * Record navigation input: switch the window to DesiredUpdateRate and
+   * push back the end of the interaction. Only with the window's
+   * FrameTimeGovernor on.
+   */
+  void NoteInteraction();
+
+  /**
+   * Go back to StillUpdateRate, with a still render, once interaction has
+   * ended.
+   */
+  void EndInteractionIfIdle();
+
+  /**
+   * Render the next refinement pass with an abort check that stops it as
+   * soon as input arrives.
+   */
+  void RenderRefinementPass();
+
+  /**
+   * AbortCheckEvent observer used during refinement. Polls GLFW with input
+   * deferred to the injected queue and aborts the render if any arrived.
+   */
+  void OnAbortCheck(vtkObject* caller, unsigned long event, void* callData);
+
+  /**
+   * Switch the window's cursor in or out of raw mode.
+   */
+  void ApplyCursorMode(bool raw);
+
+  /**
+   * Deliver the raw motion coalesced since the last call.
+   */
+  int DispatchRawMotion();
+
+  /**
+   * Shared by OnMouseBtn() and injected events, x and y as GLFW reports
+   * them.
+   */
+  int DispatchMouseButton(double x,
+                          double y,
+                          int button,
+                          int action,
+                          int mods);
   
   //@{
   /**
-   * SDL2-specific internal timer methods. See the superclass for detailed
+   * Timers are kept by the interactor and fired from the event loop, which
+   * sleeps until the next one is due. See the superclass for detailed
    * documentation.
    */
   int InternalCreateTimer(int timerId,
@@ -88,7 +327,8 @@ protected:
   /**
    * This will start up the event loop and never return. If you
    * call this method it will loop processing events until the
-   * application is exited.
+   * application is exited. Between events the loop sleeps in
+   * glfwWaitEvents() rather than polling.
    */
   void StartEventLoop() override;
 
@@ -0,0 +1,163 @@
+#ifndef vtkGlfwShaderBinaryCache_h
+#define vtkGlfwShaderBinaryCache_h
+
+#include "vtkOpenGLShaderCache.h"
+#include <cstdint> // for uint64_t
+#include <string>  // for std::string
+
+class vtkGlfwUploadContext;
+
+/**
+ * Shader cache that keeps linked program binaries on disk.
+ *
+ * Before a program is compiled, its binary is looked up in Directory under
+ * a hash of the final shader sources and the GL vendor, renderer and
+ * version strings, and loaded with glProgramBinary(). Binaries the driver
+ * rejects, e.g. after a driver update, are deleted and the program is
+ * compiled as usual. Programs without a binary are linked by the cache
+ * itself, asking the driver to keep their binaries retrievable, and
+ * written back with glGetProgramBinary(); once the directory outgrows
+ * MaximumSize the least recently used binaries are evicted. The sources
+ * are recorded next to each binary, so WarmUp() can rebuild programs in
+ * the background even when the binaries went stale. Programs using
+ * transform feedback always compile.
+ *
+ * vtkGlfwOpenGLRenderWindow installs one as its shader cache. Without a
+ * Directory it behaves exactly like vtkOpenGLShaderCache.
+ */
+class vtkGlfwShaderBinaryCache : public vtkOpenGLShaderCache
+{
+public:
+  static vtkGlfwShaderBinaryCache* New();
+  vtkTypeMacro(vtkGlfwShaderBinaryCache, vtkOpenGLShaderCache);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  //@{
+  /**
+   * Directory holding the binaries, created when the first one is
+   * written. Several processes may share it. Empty disables the disk
+   * cache. Defaults to the VTKGLFW_SHADER_CACHE environment variable.
+   */
+  vtkSetStringMacro(Directory);
+  vtkGetStringMacro(Directory);
+  //@}
+
+  //@{
+  /**
+   * Size in bytes the directory may grow to before the least recently
+   * used binaries are evicted. Default is 64 MiB.
+   */
+  vtkSetClampMacro(MaximumSize, vtkIdType, 0, VTK_ID_MAX);
+  vtkGetMacro(MaximumSize, vtkIdType);
+  //@}
+
+  using vtkOpenGLShaderCache::ReadyShaderProgram;
+
+  /**
+   * Load shader from disk if it is not compiled yet, else link it and
+   * store the result, then bind it.
+   */
+  vtkShaderProgram* ReadyShaderProgram(
+    vtkShaderProgram* shader,
+    vtkTransformFeedback* cap = nullptr) override;
+
+  //@{
+  /**
+   * Statistics since creation or ResetStatistics(): programs loaded from
+   * disk, programs taken over from WarmUp(), programs compiled for lack of
+   * a usable binary, binaries the driver rejected, binaries written and
+   * binaries evicted.
+   */
+  vtkGetMacro(NumberOfHits, vtkIdType);
+  vtkGetMacro(NumberOfWarmUpHits, vtkIdType);
+  vtkGetMacro(NumberOfMisses, vtkIdType);
+  vtkGetMacro(NumberOfRejected, vtkIdType);
+  vtkGetMacro(NumberOfWrites, vtkIdType);
+  vtkGetMacro(NumberOfEvictions, vtkIdType);
+  void ResetStatistics();
+  //@}
+
+  /**
+   * Delete every binary in Directory.
+   */
+  void Clear();
+
+  /**
+   * Queue up to maximum programs recorded in Directory for this GPU, most
+   * recently used first, to be linked on the worker of context, from the
+   * binary if the driver takes it and from the recorded sources otherwise.
+   * A program VTK asks for later is taken over from there if the worker
+   * has finished it, and compiled as usual if not. Returns the number of
+   * programs queued. Needs the render context current.
+   */
+  int WarmUp(vtkGlfwUploadContext* context, int maximum);
+
+  /**
+   * Forget the programs queued by WarmUp(). Must be called before context
+   * stops, which deletes the programs nobody took over.
+   */
+  void CancelWarmUp();
+
+  /**
+   * Programs queued by WarmUp() and not asked for yet.
+   */
+  int GetNumberOfWarmUpPrograms();
+
+protected:
+  vtkGlfwShaderBinaryCache();
+  ~vtkGlfwShaderBinaryCache() override;
+
+  /**
+   * Returns false if the driver cannot load or save program binaries or
+   * there is no Directory. Needs the context current.
+   */
+  bool IsAvailable();
+
+  /**
+   * Hash of the GPU and the final sources of shader, naming its files.
+   */
+  uint64_t GetProgramKey(vtkShaderProgram* shader);
+  std::string GetFilePath(uint64_t key, const char* extension);
+
+  /**
+   * Hand shader a linked program object in place of compiling it.
+   */
+  void AdoptProgram(vtkShaderProgram* shader, unsigned int handle);
+  bool AdoptWarmProgram(vtkShaderProgram* shader, uint64_t key);
+  bool LoadBinary(vtkShaderProgram* shader, uint64_t key);
+
+  /**
+   * Write the binary of shader, which must hold a program this cache
+   * linked or loaded, i.e. one whose binary the driver keeps retrievable.
+   */
+  void StoreBinary(vtkShaderProgram* shader, uint64_t key);
+
+  /**
+   * Delete the programs that were asked for before the worker finished
+   * them, once it has.
+   */
+  void DeleteOrphans();
+
+  /**
+   * Delete the least recently used binaries until the directory fits
+   * MaximumSize again.
+   */
+  void Evict();
+
+  char* Directory;
+  vtkIdType MaximumSize;
+  vtkIdType NumberOfHits;
+  vtkIdType NumberOfWarmUpHits;
+  vtkIdType NumberOfMisses;
+  vtkIdType NumberOfRejected;
+  vtkIdType NumberOfWrites;
+  vtkIdType NumberOfEvictions;
+  class vtkInternals;
+  vtkInternals* Internals;
+
+private:
+  vtkGlfwShaderBinaryCache(const vtkGlfwShaderBinaryCache&) = delete;
+  void operator=(const vtkGlfwShaderBinaryCache&) = delete;
+};
+
+#endif
@@ -0,0 +1,115 @@
+#ifndef vtkGlfwSharedFrameExporter_h
+#define vtkGlfwSharedFrameExporter_h
+
+#include "vtkObject.h"
+
+class vtkGlfwOpenGLRenderWindow;
+
+/**
+ * Publishes the frames of a vtkGlfwOpenGLRenderWindow to other processes
+ * through a ring of slots in POSIX shared memory.
+ *
+ * The exporter observes the window's WindowFrameEvent and starts reading
+ * each finished frame back through pixel pack buffers, RGBA and, with
+ * ExportDepth, the float depth buffer. Once the GPU is done, normally by
+ * the next frame, the pixels are copied into the next slot, without a
+ * system call. Consumers map the same memory with vtkGlfwSharedFrameReader
+ * and read the pixels in place; slots are guarded by sequence locks, so
+ * neither the readback nor a slow or dead consumer holds up rendering.
+ * Frames thus reach the readers a frame late; Flush() publishes the last
+ * ones when rendering stops. When the window grows beyond what the slots
+ * hold, the ring is replaced by a larger one under the same name. See
+ * vtkGlfwSharedFrameProtocol.h for the layout. POSIX only.
+ */
+class vtkGlfwSharedFrameExporter : public vtkObject
+{
+public:
+  static vtkGlfwSharedFrameExporter* New();
+  vtkTypeMacro(vtkGlfwSharedFrameExporter, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  //@{
+  /**
+   * The window whose frames are exported.
+   */
+  void SetRenderWindow(vtkGlfwOpenGLRenderWindow* window);
+  vtkGetObjectMacro(RenderWindow, vtkGlfwOpenGLRenderWindow);
+  //@}
+
+  /**
+   * Create the shared memory object name, e.g. "/vtkglfw-frames", and
+   * export every following frame into it. An object left behind under that
+   * name is replaced. Returns false if it could not be created.
+   */
+  bool Start(const char* name);
+
+  /**
+   * Mark the ring closed for the readers and remove it.
+   */
+  void Stop();
+
+  bool IsStarted();
+
+  /**
+   * Publish the frames still being read back, waiting for the GPU. Call
+   * it after the last frame of a burst, e.g. when the event loop goes
+   * idle, so readers get to see it before the next one is rendered.
+   */
+  void Flush();
+
+  //@{
+  /**
+   * Number of slots in the ring, read by Start(). A reader can hold on to
+   * a frame until NumberOfSlots - 1 newer ones were exported. Default is
+   * 3.
+   */
+  vtkSetClampMacro(NumberOfSlots, int, 2, 64);
+  vtkGetMacro(NumberOfSlots, int);
+  //@}
+
+  //@{
+  /**
+   * Export the depth buffer along with the colors. Default is off.
+   */
+  vtkSetMacro(ExportDepth, bool);
+  vtkGetMacro(ExportDepth, bool);
+  vtkBooleanMacro(ExportDepth, bool);
+  //@}
+
+  /**
+   * Frames published since Start(), which is also the sequence number of
+   * the last one.
+   */
+  vtkIdType GetNumberOfFramesExported();
+
+protected:
+  vtkGlfwSharedFrameExporter();
+  ~vtkGlfwSharedFrameExporter() override;
+
+  void OnFrame(vtkObject* caller, unsigned long event, void* callData);
+
+  /**
+   * Copy the frames the window has finished reading back into the ring,
+   * waiting for the GPU if wait is set.
+   */
+  void Publish(bool wait);
+
+  /**
+   * Give up on the frames the window is still reading back for us.
+   */
+  void DropReadbacks();
+
+  vtkGlfwOpenGLRenderWindow* RenderWindow;
+  unsigned long FrameObserver;
+  int NumberOfSlots;
+  bool ExportDepth;
+
+  class vtkInternals;
+  vtkInternals* Internals;
+
+private:
+  vtkGlfwSharedFrameExporter(const vtkGlfwSharedFrameExporter&) = delete;
+  void operator=(const vtkGlfwSharedFrameExporter&) = delete;
+};
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef vtkGlfwSharedFrameProtocol_h
+#define vtkGlfwSharedFrameProtocol_h
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * Shared memory layout written by vtkGlfwSharedFrameExporter and read by
+ * vtkGlfwSharedFrameReader.
+ *
+ * A POSIX shared memory object holds a RingHeader followed by
+ * NumberOfSlots slots of SlotStride bytes, each a SlotHeader followed by
+ * the pixels it points to. Frame n goes to slot n % NumberOfSlots, so a
+ * frame stays readable until NumberOfSlots - 1 newer ones are written.
+ *
+ * Slots are guarded by a sequence lock, so neither side ever blocks: the
+ * writer makes Lock odd, writes the slot and sets Lock to twice the
+ * frame's Sequence; a reader reads Lock, the slot, then Lock again and
+ * discards what it read unless both values are equal and even. Latest is
+ * published after the slot is complete. Fields are in the host's byte
+ * order; 64 bit atomics are lock-free and therefore work across processes
+ * on every platform the exporter supports.
+ */
+namespace vtkGlfwSharedFrame {
+
+const uint32_t Magic = 0x46534756; // "VGSF"
+const uint32_t Version = 1;
+
+// alignment of the slots and the pixels within them
+const uint64_t Alignment = 64;
+
+inline uint64_t
+Align(uint64_t size)
+{
+  return (size + Alignment - 1) / Alignment * Alignment;
+}
+
+struct RingHeader
+{
+  // written last, once the ring is set up
+  std::atomic<uint32_t> Magic;
+  uint32_t Version;
+  uint32_t NumberOfSlots;
+  // nonzero once the exporter stopped or moved to a new, larger ring under
+  // the same name, which readers should open instead
+  std::atomic<uint32_t> Closed;
+  // from the start of the ring to the first slot
+  uint64_t SlotsOffset;
+  uint64_t SlotStride;
+  // sequence number of the newest complete frame, 0 before the first
+  std::atomic<uint64_t> Latest;
+};
+
+struct SlotHeader
+{
+  std::atomic<uint64_t> Lock;
+  uint64_t Sequence;
+  // CLOCK_MONOTONIC nanoseconds right before the frame was swapped
+  uint64_t Timestamp;
+  uint32_t Width;
+  uint32_t Height;
+  // Width x Height RGBA pixels, bottom row first, ColorOffset bytes from
+  // the start of the slot
+  uint64_t ColorOffset;
+  uint64_t ColorSize;
+  // Width x Height float window depths in [0, 1], bottom row first;
+  // both 0 if depth is not exported
+  uint64_t DepthOffset;
+  uint64_t DepthSize;
+};
+
+static_assert(sizeof(std::atomic<uint64_t>) == sizeof(uint64_t),
+              "shared atomics must have the layout of plain integers");
+
+}
+
+#endif
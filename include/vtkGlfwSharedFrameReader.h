@@ -0,0 +1,95 @@
+#ifndef vtkGlfwSharedFrameReader_h
+#define vtkGlfwSharedFrameReader_h
+
+#include "vtkObject.h"
+
+#include <cstdint> // for uint64_t
+#include <vector>  // for std::vector
+
+/**
+ * Consumer side of vtkGlfwSharedFrameExporter: maps the exporter's shared
+ * memory read-only and hands out its frames.
+ *
+ * Peek() points at the newest frame in place, without copying; the pixels
+ * stay put until NumberOfSlots - 1 newer frames were exported, and
+ * IsValid() tells afterwards whether the exporter got to them first.
+ * Read() copies a consistent frame out instead. Neither ever blocks the
+ * exporter. When the exporter moves to a larger ring, or restarts, the
+ * reader follows it by name. Depends on nothing but VTK's common core, so
+ * a compositor can link it without the rendering libraries. POSIX only.
+ */
+class vtkGlfwSharedFrameReader : public vtkObject
+{
+public:
+  static vtkGlfwSharedFrameReader* New();
+  vtkTypeMacro(vtkGlfwSharedFrameReader, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /**
+   * Map the shared memory object name an exporter was started with.
+   * Returns false if it does not exist (yet) or is not a frame ring.
+   */
+  bool Open(const char* name);
+  void Close();
+  bool IsOpen();
+
+  struct Frame
+  {
+    uint64_t Sequence = 0;
+    // CLOCK_MONOTONIC nanoseconds
+    uint64_t Timestamp = 0;
+    int Width = 0;
+    int Height = 0;
+    // RGBA, bottom row first
+    const unsigned char* Color = nullptr;
+    // window depths, bottom row first, nullptr if not exported
+    const float* Depth = nullptr;
+  };
+
+  /**
+   * Point frame at the newest frame in shared memory. Returns false if
+   * there is none yet. Check IsValid() after using the pixels.
+   */
+  bool Peek(Frame& frame);
+
+  /**
+   * Whether the exporter has not started overwriting frame's slot, i.e.
+   * what was read from it since Peek() is intact.
+   */
+  bool IsValid(const Frame& frame);
+
+  /**
+   * Copy the newest frame into color and depth and point frame at them.
+   * Retries while the exporter overwrites the slot. Returns false if there
+   * is no frame yet.
+   */
+  bool Read(Frame& frame,
+            std::vector<unsigned char>& color,
+            std::vector<float>& depth);
+
+  /**
+   * Wait up to timeout seconds for a frame newer than sequence, polling
+   * with a growing sleep of at most a millisecond. A negative timeout
+   * waits forever. Returns false on timeout.
+   */
+  bool WaitForFrame(uint64_t sequence, double timeout = -1.0);
+
+protected:
+  vtkGlfwSharedFrameReader();
+  ~vtkGlfwSharedFrameReader() override;
+
+  /**
+   * Follow the exporter to a new ring if the mapped one is closed.
+   * Returns false if no ring is open afterwards.
+   */
+  bool Refresh();
+
+  class vtkInternals;
+  vtkInternals* Internals;
+
+private:
+  vtkGlfwSharedFrameReader(const vtkGlfwSharedFrameReader&) = delete;
+  void operator=(const vtkGlfwSharedFrameReader&) = delete;
+};
+
+#endif
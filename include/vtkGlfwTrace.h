@@ -0,0 +1,94 @@
+#ifndef vtkGlfwTrace_h
+#define vtkGlfwTrace_h
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * Timeline tracing of the event loop and render pipeline.
+ *
+ * Spans are recorded into per-thread buffers that only their own thread
+ * writes, so recording takes no lock, and are written out as Chrome trace
+ * JSON, which chrome://tracing and Perfetto open. Setting the
+ * VTKGLFW_TRACE environment variable to a file name starts tracing when
+ * the library loads and writes the file at exit; Start() and Stop() do the
+ * same at runtime. While tracing is off a span costs one relaxed atomic
+ * load.
+ */
+class vtkGlfwTrace
+{
+public:
+  /**
+   * Start recording into fileName, closing any trace already open.
+   * Returns false if the file cannot be opened.
+   */
+  static bool Start(const char* fileName);
+
+  /**
+   * Stop recording and finish the file.
+   */
+  static void Stop();
+
+  /**
+   * Write the spans recorded so far without stopping.
+   */
+  static void Flush();
+
+  static bool IsEnabled() { return Enabled.load(std::memory_order_relaxed); }
+
+  /**
+   * Nanoseconds on the trace clock.
+   */
+  static int64_t Now();
+
+  /**
+   * Record a finished span on the calling thread. name is stored, not
+   * copied, so it must be a literal or otherwise outlive the trace.
+   */
+  static void Record(const char* name, int64_t start, int64_t end);
+
+  /**
+   * Name the calling thread in the trace.
+   */
+  static void SetThreadName(const char* name);
+
+  /**
+   * Records a span from construction to destruction, if tracing was on
+   * when it started.
+   */
+  class Scope
+  {
+  public:
+    explicit Scope(const char* name)
+      : Name(vtkGlfwTrace::IsEnabled() ? name : nullptr)
+      , Start(this->Name ? vtkGlfwTrace::Now() : 0)
+    {}
+    ~Scope()
+    {
+      if (this->Name) {
+        vtkGlfwTrace::Record(this->Name, this->Start, vtkGlfwTrace::Now());
+      }
+    }
+
+  private:
+    Scope(const Scope&) = delete;
+    void operator=(const Scope&) = delete;
+
+    const char* Name;
+    int64_t Start;
+  };
+
+private:
+  static std::atomic<bool> Enabled;
+};
+
+#define VTK_GLFW_TRACE_CONCAT_(a, b) a##b
+#define VTK_GLFW_TRACE_CONCAT(a, b) VTK_GLFW_TRACE_CONCAT_(a, b)
+
+/**
+ * Trace the rest of the enclosing block as a span called name.
+ */
+#define VTK_GLFW_TRACE_SCOPE(name)                                            \
+  vtkGlfwTrace::Scope VTK_GLFW_TRACE_CONCAT(vtkGlfwTraceScope, __LINE__)(name)
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef vtkGlfwUploadContext_h
+#define vtkGlfwUploadContext_h
+
+#include "vtkObject.h"
+#include <GLFW/glfw3.h> // for ivars
+#include <functional>   // for std::function
+#include <vector>       // for std::vector
+
+class vtkGlfwOpenGLRenderWindow;
+
+/**
+ * Streams vertex buffers and textures to the GPU from a worker thread.
+ *
+ * The worker owns a hidden GLFW window whose context shares objects with a
+ * vtkGlfwOpenGLRenderWindow. Uploads are queued from the render thread and
+ * identified by a ticket; each finished upload is guarded by a fence, so the
+ * render context only ever waits on the GPU, never on the worker. Tickets
+ * hand out raw OpenGL names; textures can be wrapped with
+ * vtkTextureObject::AssignToExistingTexture().
+ *
+ * All methods except the worker itself must be called from the thread
+ * that owns the render window.
+ */
+class vtkGlfwUploadContext : public vtkObject
+{
+public:
+  static vtkGlfwUploadContext* New();
+  vtkTypeMacro(vtkGlfwUploadContext, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /**
+   * Create the shared context for window and start the worker thread.
+   * The window must already be initialized. Returns false on failure.
+   */
+  bool Start(vtkGlfwOpenGLRenderWindow* window);
+
+  /**
+   * Stop the worker, delete every upload that was never acquired and
+   * destroy the shared context. Needs the render window's context current.
+   */
+  void Stop();
+
+  /**
+   * Returns true between a successful Start() and Stop().
+   */
+  bool IsRunning();
+
+  //@{
+  /**
+   * Queue an upload and return its ticket, or -1 if the worker is not
+   * running. The data is moved into the queue.
+   */
+  vtkIdType UploadBuffer(std::vector<unsigned char> data,
+                         unsigned int usage = GL_STATIC_DRAW);
+  vtkIdType UploadTexture2D(int width,
+                            int height,
+                            int internalFormat,
+                            unsigned int format,
+                            unsigned int type,
+                            std::vector<unsigned char> pixels);
+  //@}
+
+  /**
+   * Queue a job that creates and links a program object on the worker's
+   * context and returns its name, or 0 on failure. The program is handed
+   * out by Acquire() like any other upload.
+   */
+  vtkIdType LinkProgram(std::function<unsigned int()> link);
+
+  /**
+   * Returns true once the upload for ticket has completed on the GPU.
+   * Never blocks.
+   */
+  bool IsReady(vtkIdType ticket);
+
+  /**
+   * Take ownership of the OpenGL name produced by ticket. The render
+   * context is made to wait on the upload fence, which costs no CPU time.
+   * Returns 0 if the worker has not finished the upload yet, unless wait
+   * is true, in which case this blocks until it has.
+   */
+  unsigned int Acquire(vtkIdType ticket, bool wait = false);
+
+  /**
+   * Number of uploads queued but not yet processed by the worker.
+   */
+  int GetNumberOfPendingUploads();
+
+protected:
+  vtkGlfwUploadContext();
+  ~vtkGlfwUploadContext() override;
+
+  GLFWwindow* SharedWindow;
+  class vtkInternals;
+  vtkInternals* Internals;
+
+private:
+  vtkGlfwUploadContext(const vtkGlfwUploadContext&) = delete;
+  void operator=(const vtkGlfwUploadContext&) = delete;
+};
+
+#endif
@@ -0,0 +1,140 @@
+#ifndef vtkGlfwWindowPool_h
+#define vtkGlfwWindowPool_h
+
+#include "vtkObject.h"
+#include <functional> // for std::function
+
+class vtkGlfwOpenGLRenderWindow;
+
+/**
+ * Keeps initialized vtkGlfwOpenGLRenderWindows alive between rendering
+ * jobs.
+ *
+ * Creating a window per job pays for the GLFW window, the OpenGL context,
+ * OpenGL initialization and every shader compile and buffer upload, only
+ * to throw them away with the window. Acquire() instead hands out an idle
+ * window, preferring one already at the requested size, and only creates
+ * one when none is idle. Release() strips the job's renderers, interactor
+ * and observers from the window but keeps its context, and with it the
+ * framebuffers and the compiled programs in the window's shader cache.
+ * Windows idle longer than IdleTimeout, or beyond MaximumIdleWindows, are
+ * destroyed.
+ *
+ * Windows are created and destroyed by the pool, so it must be used from
+ * the thread that runs GLFW and must outlive the windows it hands out.
+ */
+class vtkGlfwWindowPool : public vtkObject
+{
+public:
+  static vtkGlfwWindowPool* New();
+  vtkTypeMacro(vtkGlfwWindowPool, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /**
+   * Called on every window the pool creates, before Initialize(), to apply
+   * settings such as the backend, multisampling or a shader cache
+   * directory. Windows are created hidden unless it shows them.
+   */
+  using WindowSetup = std::function<void(vtkGlfwOpenGLRenderWindow*)>;
+  void SetWindowSetup(const WindowSetup& setup);
+
+  /**
+   * Hand out a window of width x height pixels, initialized and with its
+   * context current. Give it back with Release() instead of deleting it.
+   * Returns nullptr if a window could not be created.
+   */
+  vtkGlfwOpenGLRenderWindow* Acquire(int width, int height);
+
+  /**
+   * Take back a window handed out by Acquire(). Its renderers are removed,
+   * releasing what their props uploaded, and its interactor and the
+   * observers added since Acquire() are dropped; the window, its shader
+   * programs and the observers of the window setup stay.
+   */
+  void Release(vtkGlfwOpenGLRenderWindow* window);
+
+  /**
+   * Create windows of width x height pixels until count are idle, so the
+   * first jobs find them warm. Returns the number of idle windows.
+   */
+  int Reserve(int count, int width, int height);
+
+  //@{
+  /**
+   * Most windows kept idle. A window released beyond it destroys the
+   * longest idle one. Default is 4.
+   */
+  vtkSetClampMacro(MaximumIdleWindows, int, 0, VTK_INT_MAX);
+  vtkGetMacro(MaximumIdleWindows, int);
+  //@}
+
+  //@{
+  /**
+   * Seconds a window may sit idle before ReclaimIdleWindows() destroys it.
+   * Negative keeps idle windows forever. Default is 60.
+   */
+  vtkSetMacro(IdleTimeout, double);
+  vtkGetMacro(IdleTimeout, double);
+  //@}
+
+  /**
+   * Destroy the windows idle longer than IdleTimeout. Acquire() and
+   * Release() do so too; a service that goes quiet should call it now and
+   * then, e.g. after GetReclaimDelay() seconds. Returns the number of
+   * windows destroyed.
+   */
+  int ReclaimIdleWindows();
+
+  /**
+   * Seconds until the longest idle window times out: 0 if one is due, -1
+   * if none is idle or IdleTimeout is negative.
+   */
+  double GetReclaimDelay();
+
+  /**
+   * Destroy all idle windows.
+   */
+  void Clear();
+
+  //@{
+  /**
+   * Windows waiting in the pool and windows handed out.
+   */
+  int GetNumberOfIdleWindows();
+  int GetNumberOfActiveWindows();
+  //@}
+
+  //@{
+  /**
+   * Statistics since creation: windows created, Acquire() calls served by
+   * an idle window and windows destroyed for idling.
+   */
+  vtkGetMacro(NumberOfWindowsCreated, vtkIdType);
+  vtkGetMacro(NumberOfReuses, vtkIdType);
+  vtkGetMacro(NumberOfWindowsReclaimed, vtkIdType);
+  //@}
+
+protected:
+  vtkGlfwWindowPool();
+  ~vtkGlfwWindowPool() override;
+
+  /**
+   * Create and initialize a window. Returns nullptr on failure.
+   */
+  vtkGlfwOpenGLRenderWindow* NewWindow(int width, int height);
+
+  int MaximumIdleWindows;
+  double IdleTimeout;
+  vtkIdType NumberOfWindowsCreated;
+  vtkIdType NumberOfReuses;
+  vtkIdType NumberOfWindowsReclaimed;
+
+  class vtkInternals;
+  vtkInternals* Internals;
+
+private:
+  vtkGlfwWindowPool(const vtkGlfwWindowPool&) = delete;
+  void operator=(const vtkGlfwWindowPool&) = delete;
+};
+
+#endif
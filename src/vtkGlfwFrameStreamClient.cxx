@@ -0,0 +1,153 @@
+#include <cerrno>
+#include <cstring>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "vtkObjectFactory.h"
+
+#include "vtkGlfwFrameStreamClient.h"
+
+namespace {
+bool
+receiveAll(int fd, void* data, size_t size)
+{
+  auto bytes = static_cast<char*>(data);
+  while (size > 0) {
+    ssize_t received = recv(fd, bytes, size, 0);
+    if (received <= 0) {
+      if (received < 0 && errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    bytes += received;
+    size -= received;
+  }
+  return true;
+}
+}
+
+vtkStandardNewMacro(vtkGlfwFrameStreamClient);
+
+//------------------------------------------------------------------------------
+vtkGlfwFrameStreamClient::vtkGlfwFrameStreamClient()
+  : Socket(-1)
+{}
+
+//------------------------------------------------------------------------------
+vtkGlfwFrameStreamClient::~vtkGlfwFrameStreamClient()
+{
+  this->Disconnect();
+}
+
+//------------------------------------------------------------------------------
+bool
+vtkGlfwFrameStreamClient::Connect(int port, const char* host)
+{
+  this->Disconnect();
+
+  sockaddr_in address;
+  std::memset(&address, 0, sizeof(address));
+  address.sin_family = AF_INET;
+  address.sin_port = htons(static_cast<uint16_t>(port));
+  if (inet_pton(AF_INET, host, &address.sin_addr) != 1) {
+    vtkErrorMacro(<< "Invalid address " << host);
+    return false;
+  }
+
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (fd < 0 ||
+      connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address))) {
+    vtkErrorMacro(<< "Unable to connect to " << host << ":" << port << ": "
+                  << strerror(errno));
+    if (fd >= 0) {
+      close(fd);
+    }
+    return false;
+  }
+  int one = 1;
+  setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+  this->Socket = fd;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwFrameStreamClient::Disconnect()
+{
+  if (this->Socket >= 0) {
+    close(this->Socket);
+    this->Socket = -1;
+  }
+}
+
+//------------------------------------------------------------------------------
+bool
+vtkGlfwFrameStreamClient::ReceiveFrame(vtkGlfwFrameStream::FrameHeader& header,
+                                       std::vector<unsigned char>& payload,
+                                       double timeout)
+{
+  if (this->Socket < 0) {
+    return false;
+  }
+  pollfd fd = { this->Socket, POLLIN, 0 };
+  int milliseconds = timeout < 0 ? -1 : static_cast<int>(timeout * 1000);
+  if (poll(&fd, 1, milliseconds) <= 0) {
+    return false;
+  }
+
+  if (!receiveAll(this->Socket, &header, sizeof(header)) ||
+      header.Magic != vtkGlfwFrameStream::Magic) {
+    this->Disconnect();
+    return false;
+  }
+  payload.resize(header.PayloadSize);
+  if (!receiveAll(this->Socket, payload.data(), payload.size())) {
+    this->Disconnect();
+    return false;
+  }
+
+  vtkGlfwFrameStream::InputMessage ack;
+  std::memset(&ack, 0, sizeof(ack));
+  ack.Type = vtkGlfwFrameStream::MESSAGE_ACK;
+  ack.Sequence = header.Sequence;
+  return this->SendInput(ack);
+}
+
+//------------------------------------------------------------------------------
+bool
+vtkGlfwFrameStreamClient::SendInput(
+  const vtkGlfwFrameStream::InputMessage& message)
+{
+  if (this->Socket < 0) {
+    return false;
+  }
+  auto bytes = reinterpret_cast<const char*>(&message);
+  size_t size = sizeof(message);
+  while (size > 0) {
+    ssize_t sent = send(this->Socket, bytes, size, MSG_NOSIGNAL);
+    if (sent <= 0) {
+      if (sent < 0 && errno == EINTR) {
+        continue;
+      }
+      this->Disconnect();
+      return false;
+    }
+    bytes += sent;
+    size -= sent;
+  }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwFrameStreamClient::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Connected: " << this->IsConnected() << "\n";
+}
@@ -0,0 +1,765 @@
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <csetjmp>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "vtkCommand.h"
+#include "vtkObjectFactory.h"
+#include "vtk_jpeg.h"
+
+// clang-format off
+#include "vtkGlfwFrameStreamProtocol.h"
+#include "vtkGlfwFrameStreamer.h"
+#include "vtkGlfwOpenGLRenderWindow.h"
+#include "vtkGlfwRenderWindowInteractor.h"
+#include "vtkGlfwSnapshotWriter.h"
+#include "vtkGlfwWorkerPool.h"
+// clang-format on
+
+namespace {
+// frames sent but not yet acknowledged before the client counts as behind
+const int MaximumUnacknowledged = 3;
+// acknowledgements in a row without a backlog before resolution goes up
+const int CatchUpFrames = 30;
+
+// FNV-1a over 64 bit words, enough to tell whether a frame changed
+uint64_t
+hashPixels(const unsigned char* data, size_t size)
+{
+  uint64_t hash = 1469598103934665603ull;
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    uint64_t word;
+    std::memcpy(&word, data + i, 8);
+    hash = (hash ^ word) * 1099511628211ull;
+  }
+  for (; i < size; ++i) {
+    hash = (hash ^ data[i]) * 1099511628211ull;
+  }
+  return hash;
+}
+
+// box filter an RGB image by factor, rows stay bottom-up
+void
+downscale(const unsigned char* in,
+          int width,
+          int height,
+          int factor,
+          std::vector<unsigned char>& out,
+          int& outWidth,
+          int& outHeight)
+{
+  outWidth = std::max(1, width / factor);
+  outHeight = std::max(1, height / factor);
+  out.resize(size_t(outWidth) * outHeight * 3);
+  const int fx = std::min(factor, width);
+  const int fy = std::min(factor, height);
+  const unsigned int count = fx * fy;
+  for (int y = 0; y < outHeight; ++y) {
+    for (int x = 0; x < outWidth; ++x) {
+      unsigned int sum[3] = { 0, 0, 0 };
+      for (int j = 0; j < fy; ++j) {
+        const unsigned char* src =
+          in + (size_t(y * fy + j) * width + size_t(x) * fx) * 3;
+        for (int i = 0; i < fx * 3; i += 3) {
+          sum[0] += src[i];
+          sum[1] += src[i + 1];
+          sum[2] += src[i + 2];
+        }
+      }
+      unsigned char* dst = out.data() + (size_t(y) * outWidth + x) * 3;
+      dst[0] = static_cast<unsigned char>(sum[0] / count);
+      dst[1] = static_cast<unsigned char>(sum[1] / count);
+      dst[2] = static_cast<unsigned char>(sum[2] / count);
+    }
+  }
+}
+
+// everything the encoder changes after setjmp() lives here, in memory the
+// library writes through, so it is still valid after the longjmp()
+struct JPEGError
+{
+  jpeg_error_mgr Manager;
+  std::jmp_buf Jump;
+  unsigned char* Memory = nullptr;
+  unsigned long MemorySize = 0;
+};
+
+void
+jpegErrorExit(j_common_ptr cinfo)
+{
+  std::longjmp(reinterpret_cast<JPEGError*>(cinfo->err)->Jump, 1);
+}
+
+// encode bottom-up RGB pixels, the flip happens through the row pointers
+bool
+encodeJPEG(const unsigned char* pixels,
+           int width,
+           int height,
+           int quality,
+           std::vector<unsigned char>& out)
+{
+  jpeg_compress_struct cinfo;
+  JPEGError error;
+  cinfo.err = jpeg_std_error(&error.Manager);
+  error.Manager.error_exit = jpegErrorExit;
+
+  std::vector<JSAMPROW> rows(height);
+  const size_t rowBytes = size_t(width) * 3;
+  for (int i = 0; i < height; ++i) {
+    rows[i] = const_cast<JSAMPROW>(pixels + (height - 1 - i) * rowBytes);
+  }
+
+  if (setjmp(error.Jump)) {
+    jpeg_destroy_compress(&cinfo);
+    free(error.Memory);
+    return false;
+  }
+  jpeg_create_compress(&cinfo);
+  jpeg_mem_dest(&cinfo, &error.Memory, &error.MemorySize);
+  cinfo.image_width = width;
+  cinfo.image_height = height;
+  cinfo.input_components = 3;
+  cinfo.in_color_space = JCS_RGB;
+  jpeg_set_defaults(&cinfo);
+  jpeg_set_quality(&cinfo, quality, TRUE);
+  jpeg_start_compress(&cinfo, TRUE);
+  jpeg_write_scanlines(&cinfo, rows.data(), height);
+  jpeg_finish_compress(&cinfo);
+  jpeg_destroy_compress(&cinfo);
+
+  out.assign(error.Memory, error.Memory + error.MemorySize);
+  free(error.Memory);
+  return true;
+}
+
+bool
+sendAll(int fd, const void* data, size_t size)
+{
+  auto bytes = static_cast<const char*>(data);
+  while (size > 0) {
+    ssize_t sent = send(fd, bytes, size, MSG_NOSIGNAL);
+    if (sent <= 0) {
+      if (sent < 0 && errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    bytes += sent;
+    size -= sent;
+  }
+  return true;
+}
+}
+
+class vtkGlfwFrameStreamer::vtkInternals
+{
+public:
+  using Frame = std::vector<unsigned char>;
+  struct Packet
+  {
+    vtkGlfwFrameStream::FrameHeader Header;
+    std::vector<unsigned char> Payload;
+    // the connection whose last frame the payload was compared against
+    uint64_t Connection;
+  };
+
+  // Mutex guards everything below it up to the atomics. SendMutex is held
+  // while writing to the client, so its socket is never closed mid-send.
+  std::mutex Mutex;
+  std::mutex SendMutex;
+  std::condition_variable PacketReady;
+  std::deque<std::shared_ptr<Packet>> Packets;
+  std::vector<std::unique_ptr<Frame>> FreeFrames;
+  int ClientSocket = -1;
+  // counts accepted clients; socket numbers are reused, this is not
+  uint64_t Connection = 0;
+  uint32_t LastQueuedSequence = 0;
+  uint64_t LastHash = 0;
+  bool HaveHash = false;
+  int Unacknowledged = 0;
+  int CaughtUp = 0;
+  int Downscale = 1;
+  int MaximumDownscale = 8;
+
+  std::unique_ptr<vtkGlfwWorkerPool> Encoders;
+  std::thread Network;
+  std::thread Sender;
+  int ListenSocket = -1;
+  int Port = 0;
+  uint32_t NextSequence = 0;
+  std::atomic<bool> Quit{ false };
+  std::atomic<bool> Connected{ false };
+  std::atomic<vtkIdType> Sent{ 0 };
+  std::atomic<vtkIdType> Unchanged{ 0 };
+  std::atomic<vtkIdType> Dropped{ 0 };
+
+  std::unique_ptr<Frame> AcquireFrame(size_t size)
+  {
+    std::unique_ptr<Frame> frame;
+    {
+      std::lock_guard<std::mutex> lock(this->Mutex);
+      if (!this->FreeFrames.empty()) {
+        frame = std::move(this->FreeFrames.back());
+        this->FreeFrames.pop_back();
+      }
+    }
+    if (!frame) {
+      frame.reset(new Frame);
+    }
+    frame->resize(size);
+    return frame;
+  }
+
+  void RecycleFrame(std::unique_ptr<Frame> frame)
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    this->FreeFrames.push_back(std::move(frame));
+  }
+
+  void Encode(std::unique_ptr<Frame> frame,
+              int width,
+              int height,
+              uint32_t sequence,
+              int format,
+              int quality)
+  {
+    uint64_t hash = hashPixels(frame->data(), frame->size());
+    int scale;
+    uint64_t connection;
+    {
+      std::lock_guard<std::mutex> lock(this->Mutex);
+      if (this->HaveHash && hash == this->LastHash) {
+        ++this->Unchanged;
+        this->FreeFrames.push_back(std::move(frame));
+        return;
+      }
+      scale = this->Downscale;
+      connection = this->Connection;
+    }
+
+    thread_local std::vector<unsigned char> scaled;
+    const unsigned char* pixels = frame->data();
+    int outWidth = width;
+    int outHeight = height;
+    if (scale > 1) {
+      downscale(pixels, width, height, scale, scaled, outWidth, outHeight);
+      pixels = scaled.data();
+    }
+
+    auto packet = std::make_shared<Packet>();
+    packet->Connection = connection;
+    bool ok;
+    if (format == vtkGlfwFrameStream::FORMAT_PNG) {
+      auto& payload = packet->Payload;
+      ok = vtkGlfwSnapshotWriter::EncodePNG(
+        pixels,
+        outWidth,
+        outHeight,
+        3,
+        1,
+        [&payload](const unsigned char* data, size_t size) {
+          payload.insert(payload.end(), data, data + size);
+          return true;
+        });
+    } else {
+      ok = encodeJPEG(pixels, outWidth, outHeight, quality, packet->Payload);
+    }
+    this->RecycleFrame(std::move(frame));
+    if (!ok) {
+      ++this->Dropped;
+      return;
+    }
+
+    auto& header = packet->Header;
+    header.Magic = vtkGlfwFrameStream::Magic;
+    header.Sequence = sequence;
+    header.Width = outWidth;
+    header.Height = outHeight;
+    header.Downscale = scale;
+    header.Format = format;
+    header.PayloadSize = static_cast<uint32_t>(packet->Payload.size());
+    header.Reserved = 0;
+
+    {
+      std::lock_guard<std::mutex> lock(this->Mutex);
+      // workers finish out of order, never send an older frame, nor one
+      // meant for a client that has gone since
+      if (this->ClientSocket < 0 || this->Connection != connection ||
+          int32_t(sequence - this->LastQueuedSequence) <= 0) {
+        ++this->Dropped;
+        return;
+      }
+      this->LastQueuedSequence = sequence;
+      // only a frame that is sent makes its duplicates redundant
+      this->LastHash = hash;
+      this->HaveHash = true;
+      if (!this->Packets.empty()) {
+        // the previous frame is still waiting for the client, so it is
+        // behind; replace it and lower the resolution
+        this->Dropped += this->Packets.size();
+        this->Packets.clear();
+        if (this->Unacknowledged >= MaximumUnacknowledged) {
+          this->Downscale =
+            std::min(this->Downscale * 2, this->MaximumDownscale);
+          this->CaughtUp = 0;
+        }
+      }
+      this->Packets.push_back(packet);
+    }
+    this->PacketReady.notify_one();
+  }
+
+  void RunSender()
+  {
+    for (;;) {
+      std::shared_ptr<Packet> packet;
+      int fd;
+      {
+        std::unique_lock<std::mutex> lock(this->Mutex);
+        this->PacketReady.wait(lock, [this] {
+          return this->Quit ||
+                 (!this->Packets.empty() &&
+                  this->Unacknowledged < MaximumUnacknowledged);
+        });
+        if (this->Quit) {
+          break;
+        }
+        packet = this->Packets.front();
+        this->Packets.pop_front();
+        fd = this->ClientSocket;
+        if (fd < 0 || this->Connection != packet->Connection) {
+          continue;
+        }
+        ++this->Unacknowledged;
+      }
+
+      std::lock_guard<std::mutex> sendLock(this->SendMutex);
+      {
+        // fd may have been closed and handed to a new client meanwhile
+        std::lock_guard<std::mutex> lock(this->Mutex);
+        if (this->ClientSocket != fd ||
+            this->Connection != packet->Connection) {
+          ++this->Dropped;
+          continue;
+        }
+      }
+      if (sendAll(fd, &packet->Header, sizeof(packet->Header)) &&
+          sendAll(fd, packet->Payload.data(), packet->Payload.size())) {
+        ++this->Sent;
+      }
+      // a failed send shows up as a hangup on the network thread
+    }
+  }
+
+  void Disconnect(int fd)
+  {
+    shutdown(fd, SHUT_RDWR);
+    std::lock_guard<std::mutex> sendLock(this->SendMutex);
+    {
+      std::lock_guard<std::mutex> lock(this->Mutex);
+      if (this->ClientSocket == fd) {
+        this->ClientSocket = -1;
+        this->Packets.clear();
+        this->Connected = false;
+      }
+    }
+    close(fd);
+  }
+
+  void Accept()
+  {
+    int fd = accept(this->ListenSocket, nullptr, nullptr);
+    if (fd < 0) {
+      return;
+    }
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    int previous;
+    {
+      std::lock_guard<std::mutex> lock(this->Mutex);
+      previous = this->ClientSocket;
+    }
+    // one viewer at a time, the newest wins
+    if (previous >= 0) {
+      this->Disconnect(previous);
+    }
+
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    this->ClientSocket = fd;
+    ++this->Connection;
+    this->HaveHash = false;
+    this->Unacknowledged = 0;
+    this->CaughtUp = 0;
+    this->Downscale = 1;
+    this->Connected = true;
+  }
+
+  void Handle(vtkGlfwFrameStreamer* self,
+              const vtkGlfwFrameStream::InputMessage& message)
+  {
+    using namespace vtkGlfwFrameStream;
+    if (message.Type == MESSAGE_ACK) {
+      {
+        std::lock_guard<std::mutex> lock(this->Mutex);
+        this->Unacknowledged = std::max(0, this->Unacknowledged - 1);
+        if (this->Unacknowledged == 0 && this->Downscale > 1 &&
+            ++this->CaughtUp >= CatchUpFrames) {
+          this->Downscale /= 2;
+          this->CaughtUp = 0;
+          // resend the current picture at the better resolution
+          this->HaveHash = false;
+        }
+      }
+      this->PacketReady.notify_one();
+      return;
+    }
+
+    vtkGlfwRenderWindowInteractor* iren = self->GetInteractor();
+    if (!iren) {
+      return;
+    }
+    vtkGlfwRenderWindowInteractor::InjectedEvent event;
+    switch (message.Type) {
+      case MESSAGE_MOUSE_MOVE:
+        event.Type = vtkGlfwRenderWindowInteractor::InjectedEvent::MOUSE_MOVE;
+        break;
+      case MESSAGE_MOUSE_BUTTON:
+        event.Type =
+          vtkGlfwRenderWindowInteractor::InjectedEvent::MOUSE_BUTTON;
+        break;
+      case MESSAGE_SCROLL:
+        event.Type = vtkGlfwRenderWindowInteractor::InjectedEvent::SCROLL;
+        break;
+      case MESSAGE_KEY:
+        event.Type = vtkGlfwRenderWindowInteractor::InjectedEvent::KEY;
+        break;
+      case MESSAGE_CHAR:
+        event.Type = vtkGlfwRenderWindowInteractor::InjectedEvent::CHAR;
+        break;
+      default:
+        return;
+    }
+    event.X = message.X;
+    event.Y = message.Y;
+    event.Button = message.Button;
+    event.Action = message.Action;
+    event.Key = message.Key;
+    event.Mods = message.Mods;
+    event.Delta = message.Delta;
+    event.Codepoint = message.Codepoint;
+    std::memcpy(event.KeySym, message.KeySym, sizeof(event.KeySym));
+    event.KeySym[sizeof(event.KeySym) - 1] = '\0';
+    iren->InjectEvent(event);
+  }
+
+  void RunNetwork(vtkGlfwFrameStreamer* self)
+  {
+    std::vector<char> pending;
+    int connected = -1;
+    while (!this->Quit) {
+      int client;
+      {
+        std::lock_guard<std::mutex> lock(this->Mutex);
+        client = this->ClientSocket;
+      }
+      if (client != connected) {
+        pending.clear();
+        connected = client;
+      }
+
+      pollfd fds[2] = { { this->ListenSocket, POLLIN, 0 },
+                        { client, POLLIN, 0 } };
+      int count = poll(fds, client >= 0 ? 2 : 1, 100);
+      if (count <= 0) {
+        continue;
+      }
+      if (fds[0].revents & POLLIN) {
+        this->Accept();
+        continue;
+      }
+      if (client < 0 || !(fds[1].revents & (POLLIN | POLLHUP | POLLERR))) {
+        continue;
+      }
+
+      char buffer[4096];
+      ssize_t received = recv(client, buffer, sizeof(buffer), 0);
+      if (received <= 0) {
+        this->Disconnect(client);
+        continue;
+      }
+      pending.insert(pending.end(), buffer, buffer + received);
+      const size_t messageSize = sizeof(vtkGlfwFrameStream::InputMessage);
+      size_t offset = 0;
+      for (; offset + messageSize <= pending.size(); offset += messageSize) {
+        vtkGlfwFrameStream::InputMessage message;
+        std::memcpy(&message, pending.data() + offset, messageSize);
+        this->Handle(self, message);
+      }
+      pending.erase(pending.begin(), pending.begin() + offset);
+    }
+  }
+};
+
+vtkStandardNewMacro(vtkGlfwFrameStreamer);
+
+//------------------------------------------------------------------------------
+vtkGlfwFrameStreamer::vtkGlfwFrameStreamer()
+  : RenderWindow(nullptr)
+  , Interactor(nullptr)
+  , FrameObserver(0)
+  , Format(FORMAT_JPEG)
+  , Quality(80)
+  , EncoderThreads(2)
+  , MaximumDownscale(8)
+  , Internals(new vtkInternals)
+{}
+
+//------------------------------------------------------------------------------
+vtkGlfwFrameStreamer::~vtkGlfwFrameStreamer()
+{
+  this->Stop();
+  this->SetRenderWindow(nullptr);
+  this->SetInteractor(nullptr);
+  delete this->Internals;
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwFrameStreamer::SetRenderWindow(vtkGlfwOpenGLRenderWindow* window)
+{
+  if (this->RenderWindow == window) {
+    return;
+  }
+  if (this->RenderWindow) {
+    this->RenderWindow->RemoveObserver(this->FrameObserver);
+    this->RenderWindow->UnRegister(this);
+  }
+  this->RenderWindow = window;
+  if (this->RenderWindow) {
+    this->RenderWindow->Register(this);
+    this->FrameObserver = this->RenderWindow->AddObserver(
+      vtkCommand::WindowFrameEvent, this, &vtkGlfwFrameStreamer::OnFrame);
+  }
+  this->Modified();
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwFrameStreamer::SetInteractor(vtkGlfwRenderWindowInteractor* iren)
+{
+  if (this->Interactor == iren) {
+    return;
+  }
+  if (this->Internals->Network.joinable()) {
+    vtkErrorMacro(<< "Set the interactor before Start().");
+    return;
+  }
+  if (this->Interactor) {
+    this->Interactor->UnRegister(this);
+  }
+  this->Interactor = iren;
+  if (this->Interactor) {
+    this->Interactor->Register(this);
+  }
+  this->Modified();
+}
+
+//------------------------------------------------------------------------------
+bool
+vtkGlfwFrameStreamer::Start(int port)
+{
+  auto internals = this->Internals;
+  if (internals->Network.joinable()) {
+    return true;
+  }
+
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (fd < 0) {
+    vtkErrorMacro(<< "Unable to create a socket: " << strerror(errno));
+    return false;
+  }
+  int one = 1;
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+  sockaddr_in address;
+  std::memset(&address, 0, sizeof(address));
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  address.sin_port = htons(static_cast<uint16_t>(port));
+  socklen_t length = sizeof(address);
+  if (bind(fd, reinterpret_cast<sockaddr*>(&address), length) != 0 ||
+      listen(fd, 1) != 0 ||
+      getsockname(fd, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+    vtkErrorMacro(<< "Unable to listen on port " << port << ": "
+                  << strerror(errno));
+    close(fd);
+    return false;
+  }
+
+  internals->ListenSocket = fd;
+  internals->Port = ntohs(address.sin_port);
+  internals->MaximumDownscale = this->MaximumDownscale;
+  internals->Quit = false;
+  internals->Sent = 0;
+  internals->Unchanged = 0;
+  internals->Dropped = 0;
+  internals->Encoders.reset(new vtkGlfwWorkerPool(this->EncoderThreads));
+  internals->Sender = std::thread([internals] { internals->RunSender(); });
+  internals->Network =
+    std::thread([internals, this] { internals->RunNetwork(this); });
+  vtkDebugMacro(<< "Streaming frames on 127.0.0.1:" << internals->Port);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwFrameStreamer::Stop()
+{
+  auto internals = this->Internals;
+  if (!internals->Network.joinable()) {
+    return;
+  }
+
+  internals->Quit = true;
+  {
+    // wake the sender while holding the lock so the notification is not lost
+    std::lock_guard<std::mutex> lock(internals->Mutex);
+    internals->PacketReady.notify_all();
+  }
+  internals->Network.join();
+  internals->Sender.join();
+
+  int client;
+  {
+    std::lock_guard<std::mutex> lock(internals->Mutex);
+    client = internals->ClientSocket;
+  }
+  if (client >= 0) {
+    internals->Disconnect(client);
+  }
+  // pending encodes find no client and return their frames
+  internals->Encoders.reset();
+
+  close(internals->ListenSocket);
+  internals->ListenSocket = -1;
+  internals->Port = 0;
+}
+
+//------------------------------------------------------------------------------
+int
+vtkGlfwFrameStreamer::GetPort()
+{
+  return this->Internals->Port;
+}
+
+//------------------------------------------------------------------------------
+bool
+vtkGlfwFrameStreamer::IsClientConnected()
+{
+  return this->Internals->Connected;
+}
+
+//------------------------------------------------------------------------------
+int
+vtkGlfwFrameStreamer::GetDownscale()
+{
+  std::lock_guard<std::mutex> lock(this->Internals->Mutex);
+  return this->Internals->Downscale;
+}
+
+//------------------------------------------------------------------------------
+vtkIdType
+vtkGlfwFrameStreamer::GetNumberOfFramesSent()
+{
+  return this->Internals->Sent;
+}
+
+vtkIdType
+vtkGlfwFrameStreamer::GetNumberOfFramesUnchanged()
+{
+  return this->Internals->Unchanged;
+}
+
+vtkIdType
+vtkGlfwFrameStreamer::GetNumberOfFramesDropped()
+{
+  return this->Internals->Dropped;
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwFrameStreamer::OnFrame(vtkObject*, unsigned long, void*)
+{
+  auto internals = this->Internals;
+  if (!internals->Connected || !internals->Encoders) {
+    return;
+  }
+  // never stall the render thread on a slow encoder
+  if (internals->Encoders->GetNumberOfPendingTasks() >
+      internals->Encoders->GetNumberOfThreads()) {
+    ++internals->Dropped;
+    return;
+  }
+
+  const int* size = this->RenderWindow->GetSize();
+  const int width = size[0];
+  const int height = size[1];
+  if (width <= 0 || height <= 0) {
+    return;
+  }
+  auto frame = internals->AcquireFrame(size_t(width) * height * 3);
+  if (!this->RenderWindow->ReadFramePixels(frame->data(), 3)) {
+    internals->RecycleFrame(std::move(frame));
+    return;
+  }
+
+  const uint32_t sequence = ++internals->NextSequence;
+  const int format = this->Format;
+  const int quality = this->Quality;
+  internals->Encoders->Submit(
+    std::move(frame),
+    [internals, width, height, sequence, format, quality](
+      std::unique_ptr<vtkInternals::Frame> pixels) {
+      internals->Encode(
+        std::move(pixels), width, height, sequence, format, quality);
+    });
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwFrameStreamer::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+
+  os << indent << "RenderWindow: " << this->RenderWindow << "\n";
+  os << indent << "Interactor: " << this->Interactor << "\n";
+  os << indent << "Port: " << this->GetPort() << "\n";
+  os << indent << "Format: " << (this->Format == FORMAT_PNG ? "PNG" : "JPEG")
+     << "\n";
+  os << indent << "Quality: " << this->Quality << "\n";
+  os << indent << "EncoderThreads: " << this->EncoderThreads << "\n";
+  os << indent << "MaximumDownscale: " << this->MaximumDownscale << "\n";
+  os << indent << "Downscale: " << this->GetDownscale() << "\n";
+  os << indent << "FramesSent: " << this->GetNumberOfFramesSent() << "\n";
+  os << indent << "FramesUnchanged: " << this->GetNumberOfFramesUnchanged()
+     << "\n";
+  os << indent << "FramesDropped: " << this->GetNumberOfFramesDropped()
+     << "\n";
+}
@@ -1,22 +1,148 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
 #include <string>
+#include <vector>
 
 #include "vtkCommand.h"
 #include "vtkIdList.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkOpenGLError.h"
+#include "vtkOpenGLFramebufferObject.h"
 #include "vtkOpenGLRenderWindow.h"
 #include "vtkOpenGLRenderer.h"
 #include "vtkOpenGLShaderCache.h"
 #include "vtkOpenGLState.h"
 #include "vtkOpenGLVertexBufferObjectCache.h"
 #include "vtkRendererCollection.h"
+#include "vtk_glew.h"
 
 // clang-format off
 #include "vtkGlfwOpenGLRenderWindow.h"
+#include "vtkGlfwPerformanceHud.h"
+#include "vtkGlfwPixelReadback.h"
 #include "vtkGlfwRenderWindowInteractor.h"
+#include "vtkGlfwShaderBinaryCache.h"
+#include "vtkGlfwSnapshotWriter.h"
+#include "vtkGlfwTrace.h"
+#include "vtkGlfwUploadContext.h"
 // clang-format on
 
+namespace vtkGlfwOpenGLRenderWindow_detail {
+void
+wnSizeCallback(GLFWwindow* wnd, int w, int h)
+{
+  auto inst =
+    reinterpret_cast<vtkGlfwOpenGLRenderWindow*>(glfwGetWindowUserPointer(wnd));
+  inst->OnSize(w, h);
+}
+void
+wnPosCallback(GLFWwindow* wnd, int x, int y)
+{
+  auto inst =
+    reinterpret_cast<vtkGlfwOpenGLRenderWindow*>(glfwGetWindowUserPointer(wnd));
+  inst->OnPosition(x, y);
+}
+void
+fbSizeCallback(GLFWwindow* wnd, int w, int h)
+{
+  auto inst =
+    reinterpret_cast<vtkGlfwOpenGLRenderWindow*>(glfwGetWindowUserPointer(wnd));
+  inst->OnFramebufferSize(w, h);
+}
+void
+contentScaleCallback(GLFWwindow* wnd, float xs, float ys)
+{
+  auto inst =
+    reinterpret_cast<vtkGlfwOpenGLRenderWindow*>(glfwGetWindowUserPointer(wnd));
+  inst->OnContentScale(xs, ys);
+}
+void
+focusCallback(GLFWwindow* wnd, int focused)
+{
+  auto inst =
+    reinterpret_cast<vtkGlfwOpenGLRenderWindow*>(glfwGetWindowUserPointer(wnd));
+  inst->OnFocus(focused);
+}
+void
+iconifyCallback(GLFWwindow* wnd, int iconified)
+{
+  auto inst =
+    reinterpret_cast<vtkGlfwOpenGLRenderWindow*>(glfwGetWindowUserPointer(wnd));
+  inst->OnIconify(iconified);
+}
+void
+refreshCallback(GLFWwindow* wnd)
+{
+  auto inst =
+    reinterpret_cast<vtkGlfwOpenGLRenderWindow*>(glfwGetWindowUserPointer(wnd));
+  inst->OnRefresh();
+}
+
+const char*
+backendName(int backend)
+{
+  switch (backend) {
+    case vtkGlfwOpenGLRenderWindow::BACKEND_DISPLAY:
+      return "display";
+    case vtkGlfwOpenGLRenderWindow::BACKEND_EGL:
+      return "egl";
+    case vtkGlfwOpenGLRenderWindow::BACKEND_OSMESA:
+      return "osmesa";
+    default:
+      return "auto";
+  }
+}
+
+// free video memory in KiB, -1 if the driver does not tell
+GLint
+availableVideoMemory()
+{
+  // GL_GPU_MEMORY_INFO_CURRENT_AVAILABLE_VIDMEM_NVX, GL_TEXTURE_FREE_MEMORY_ATI
+  GLint free[4] = { -1, -1, -1, -1 };
+  if (glfwExtensionSupported("GL_NVX_gpu_memory_info")) {
+    glGetIntegerv(0x9049, free);
+  } else if (glfwExtensionSupported("GL_ATI_meminfo")) {
+    glGetIntegerv(0x87FC, free);
+  }
+  return free[0];
+}
+
+// backends to try, in order
+std::vector<int>
+backendCandidates(int requested)
+{
+  using W = vtkGlfwOpenGLRenderWindow;
+  if (requested == W::BACKEND_AUTO) {
+    const char* env = getenv("VTKGLFW_BACKEND");
+    const std::string name = env ? env : "";
+    for (int backend = W::BACKEND_DISPLAY; backend <= W::BACKEND_OSMESA;
+         ++backend) {
+      if (name == backendName(backend)) {
+        requested = backend;
+      }
+    }
+  }
+
+  bool display = true;
+#if defined(__unix__) && !defined(__APPLE__)
+  display = getenv("DISPLAY") || getenv("WAYLAND_DISPLAY");
+#endif
+  std::vector<int> order;
+  if (display) {
+    order = { W::BACKEND_DISPLAY, W::BACKEND_EGL, W::BACKEND_OSMESA };
+  } else {
+    order = { W::BACKEND_EGL, W::BACKEND_OSMESA, W::BACKEND_DISPLAY };
+  }
+  if (requested != W::BACKEND_AUTO) {
+    order.erase(std::find(order.begin(), order.end(), requested));
+    order.insert(order.begin(), requested);
+  }
+  return order;
+}
+}
+
 vtkStandardNewMacro(vtkGlfwOpenGLRenderWindow);
 
 const std::string vtkGlfwOpenGLRenderWindow::DEFAULT_BASE_WINDOW_NAME =
@@ -25,10 +151,56 @@ const std::string vtkGlfwOpenGLRenderWindow::DEFAULT_BASE_WINDOW_NAME =
 vtkGlfwOpenGLRenderWindow::vtkGlfwOpenGLRenderWindow()
   : WindowId(nullptr)
   , ContextId(nullptr)
+  , MaximumTileSize(2048)
+  , RenderingTiles(false)
+  , UploadContext(nullptr)
+  , FullScreenMode(FULLSCREEN_EXCLUSIVE)
+  , FullScreenMonitor(-1)
+  , FullScreenVideoMode{ 0, 0, 0 }
+  , WindowedGeometry{ 0, 0, 0, 0 }
+  , BorderlessActive(false)
+  , FramebufferSize{ 0, 0 }
+  , ContentScale{ 1.0f, 1.0f }
+  , SnapshotWriter(nullptr)
+  , SnapshotThreads(2)
+  , MaximumPendingSnapshots(8)
+  , SnapshotCompressionLevel(3)
+  , Focused(false)
+  , Iconified(false)
+  , PauseWhenIconified(true)
+  , UnfocusedFrameRate(10.0)
+  , DeferredRender(false)
+  , LastRenderTime(0.0)
+  , FrameTimeGovernor(false)
+  , FrameTimeSmoothing(0.25)
+  , LastFrameTime(0.0)
+  , SmoothedFrameTime(0.0)
+  , SmoothedFrameOverhead(0.0)
+  , NumberOfFrames(0)
+  , NumberOfContextSwitches(0)
+  , Backend(BACKEND_AUTO)
+  , ActiveBackend(BACKEND_AUTO)
+  , StartupTime(0.0)
+  , TrimDelay(-1.0)
+  , HiddenSince(0.0)
+  , Trimmed(false)
+  , ReclaimedMemory(0)
+  , WarmUpShaders(false)
+  , MaximumWarmUpPrograms(64)
+  , ShowPerformanceHud(false)
+  , PerformanceHud(nullptr)
+  , PixelReadback(nullptr)
 {
+  this->ScreenSize[0] = 0;
+  this->ScreenSize[1] = 0;
+
   this->SetWindowName(DEFAULT_BASE_WINDOW_NAME.c_str());
   this->SetStencilCapable(1);
 
+  // inert until it is given a directory
+  this->ShaderCache->Delete();
+  this->ShaderCache = vtkGlfwShaderBinaryCache::New();
+
   // set position to -1 to let SDL place the window
   // SetPosition will still work. Defaults of 0,0 result
   // in the window title bar being off screen.
@@ -39,6 +211,9 @@ vtkGlfwOpenGLRenderWindow::vtkGlfwOpenGLRenderWindow()
 vtkGlfwOpenGLRenderWindow::~vtkGlfwOpenGLRenderWindow()
 {
   this->Finalize();
+  delete this->SnapshotWriter;
+  delete this->PerformanceHud;
+  delete this->PixelReadback;
 
   vtkRenderer* ren;
   vtkCollectionSimpleIterator rit;
@@ -66,6 +241,12 @@ vtkGlfwOpenGLRenderWindow::CleanUpRenderers()
   // is being removed (the RendererCollection is removed by vtkRenderWindow's
   // destructor)
   this->ReleaseGraphicsResources(this);
+  if (this->PerformanceHud) {
+    this->PerformanceHud->ReleaseGraphicsResources();
+  }
+  if (this->PixelReadback) {
+    this->PixelReadback->ReleaseGraphicsResources();
+  }
 }
 
 void
@@ -80,8 +261,12 @@ vtkGlfwOpenGLRenderWindow::SetWindowName(const char* title)
 void
 vtkGlfwOpenGLRenderWindow::MakeCurrent()
 {
+  VTK_GLFW_TRACE_SCOPE("MakeCurrent");
   if (this->WindowId)
   {
+    if (glfwGetCurrentContext() != this->WindowId) {
+      ++this->NumberOfContextSwitches;
+    }
     glfwMakeContextCurrent(this->WindowId);
     this->ContextId = this->WindowId;
   }
@@ -90,6 +275,7 @@ vtkGlfwOpenGLRenderWindow::MakeCurrent()
 void
 vtkGlfwOpenGLRenderWindow::PushContext()
 {
+  VTK_GLFW_TRACE_SCOPE("PushContext");
   auto current = glfwGetCurrentContext();
   this->ContextStack.push(current);
   this->WindowStack.push(current);
@@ -100,13 +286,16 @@ vtkGlfwOpenGLRenderWindow::PushContext()
 void
 vtkGlfwOpenGLRenderWindow::PopContext()
 {
+  VTK_GLFW_TRACE_SCOPE("PopContext");
   auto current = glfwGetCurrentContext();
   auto target = this->ContextStack.top();
   auto wind = this->WindowStack.top();
   this->ContextStack.pop();
   this->WindowStack.pop();
-  if (target != current)
+  if (target != current) {
+    ++this->NumberOfContextSwitches;
     glfwMakeContextCurrent(wind);
+  }
 }
 
 //------------------------------------------------------------------------------
@@ -158,12 +347,95 @@ vtkGlfwOpenGLRenderWindow::SetPosition(int x, int y)
 void
 vtkGlfwOpenGLRenderWindow::Frame()
 {
+  VTK_GLFW_TRACE_SCOPE("Frame");
   this->Superclass::Frame();
-  if (!this->AbortRender && this->DoubleBuffer && this->SwapBuffers) {
+  if (this->PerformanceHud) {
+    // also closes a timer left open by hiding the HUD mid-frame
+    this->PerformanceHud->EndFrame();
+  }
+  // a tile of RenderTiled() is not a frame of its own
+  const bool finished = !this->AbortRender && !this->RenderingTiles;
+  if (finished) {
+    ++this->NumberOfFrames;
+  }
+  if (finished && this->HasObserver(vtkCommand::WindowFrameEvent)) {
+    VTK_GLFW_TRACE_SCOPE("WindowFrameEvent");
+    this->InvokeEvent(vtkCommand::WindowFrameEvent, nullptr);
+  }
+  // display-less backends have no surface to swap
+  if (!this->AbortRender && this->DoubleBuffer && this->SwapBuffers &&
+      this->ActiveBackend == BACKEND_DISPLAY) {
+    if (this->ShowPerformanceHud && !this->UseOffScreenBuffers) {
+      VTK_GLFW_TRACE_SCOPE("DrawPerformanceHud");
+      this->DrawPerformanceHud();
+    }
+    VTK_GLFW_TRACE_SCOPE("SwapBuffers");
     glfwSwapBuffers(this->WindowId);
   }
 }
 
+//------------------------------------------------------------------------------
+void
+vtkGlfwOpenGLRenderWindow::Start()
+{
+  this->Superclass::Start();
+  if (this->ShowPerformanceHud && this->PerformanceHud) {
+    this->PerformanceHud->BeginFrame();
+  }
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwOpenGLRenderWindow::TogglePerformanceHud()
+{
+  this->SetShowPerformanceHud(!this->ShowPerformanceHud);
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwOpenGLRenderWindow::DrawPerformanceHud()
+{
+  if (!this->PerformanceHud) {
+    // the first frame goes untimed
+    this->PerformanceHud = new vtkGlfwPerformanceHud;
+  }
+
+  vtkGlfwPerformanceHud::Counters counters;
+  counters.FrameTime = this->LastFrameTime;
+  counters.Frames = this->NumberOfFrames;
+  counters.ContextSwitches = this->NumberOfContextSwitches;
+  auto iren = this->Interactor;
+  if (iren && iren->IsA("vtkGlfwRenderWindowInteractor")) {
+    counters.Events =
+      static_cast<vtkGlfwRenderWindowInteractor*>(iren)->GetNumberOfEvents();
+  }
+
+  // onto the default framebuffer, which Superclass::Frame() blitted to
+  auto ostate = this->GetState();
+  ostate->PushDrawFramebufferBinding();
+  ostate->vtkglBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+  {
+    vtkOpenGLState::ScopedglViewport viewport(ostate);
+    vtkOpenGLState::ScopedglEnableDisable depth(ostate, GL_DEPTH_TEST);
+    vtkOpenGLState::ScopedglEnableDisable blend(ostate, GL_BLEND);
+    vtkOpenGLState::ScopedglEnableDisable scissor(ostate, GL_SCISSOR_TEST);
+    vtkOpenGLState::ScopedglEnableDisable cull(ostate, GL_CULL_FACE);
+    vtkOpenGLState::ScopedglBlendFuncSeparate blendFunc(ostate);
+    ostate->vtkglDisable(GL_DEPTH_TEST);
+    ostate->vtkglDisable(GL_SCISSOR_TEST);
+    ostate->vtkglDisable(GL_CULL_FACE);
+    ostate->vtkglEnable(GL_BLEND);
+    ostate->vtkglBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    ostate->vtkglViewport(
+      0, 0, this->FramebufferSize[0], this->FramebufferSize[1]);
+    this->PerformanceHud->Draw(this->FramebufferSize[0],
+                               this->FramebufferSize[1],
+                               this->ContentScale[0],
+                               counters);
+  }
+  ostate->PopDrawFramebufferBinding();
+}
+
 int
 vtkGlfwOpenGLRenderWindow::GetColorBufferSizes(int* rgba)
 {
@@ -191,8 +463,14 @@ vtkGlfwOpenGLRenderWindow::SetShowWindow(bool val)
       glfwHideWindow(this->WindowId);
     }
     this->Mapped = val;
+    if (!val) {
+      this->HiddenSince = glfwGetTime();
+    }
   }
   this->Superclass::SetShowWindow(val);
+  if (val && this->Trimmed) {
+    this->Render();
+  }
 }
 
 void
@@ -202,6 +480,7 @@ vtkGlfwOpenGLRenderWindow::CreateAWindow()
   int width = ((this->Size[0] > 0) ? this->Size[0] : 300);
   this->SetSize(width, height);
 
+  glfwWindowHint(GLFW_VISIBLE, this->ShowWindow ? GLFW_TRUE : GLFW_FALSE);
   this->WindowId = glfwCreateWindow(width,
                                     height,
                                     this->WindowName,
@@ -210,35 +489,375 @@ vtkGlfwOpenGLRenderWindow::CreateAWindow()
   this->MakeCurrent();
 
   if (this->WindowId) {
-    GLFWmonitor* mon = glfwGetPrimaryMonitor();
-    const GLFWvidmode* mode = glfwGetVideoMode(mon);
-    int wmm(0), hmm(0);
-    glfwGetMonitorPhysicalSize(mon, &wmm, &hmm);
-    float dpi = (float)mode->width * (float)mode->height /
-                ((float)wmm * (float)hmm * 0.0393701f * 0.0393701f);
-    float xs(0), ys(0);
-    glfwGetMonitorContentScale(mon, &xs, &ys);
-    vtkDebugMacro(<< "Pixels " << mode->width << "x" << mode->height);
-    vtkDebugMacro(<< "Screen " << wmm << "x" << hmm << "(mm)");
-    vtkDebugMacro(<< "Red" << mode->redBits);
-    vtkDebugMacro(<< "Blue" << mode->blueBits);
-    vtkDebugMacro(<< "Green" << mode->greenBits);
-    vtkDebugMacro(<< "Refresh-Rate" << mode->refreshRate);
-    vtkDebugMacro(<< "Native" << dpi << "DPI");
-    vtkDebugMacro(<< "Current" << xs * dpi << "DPI");
-    vtkDebugMacro(<< "x-scale" << xs);
-    vtkDebugMacro(<< "y-scale" << ys);
-    this->SetDPI(xs * dpi);
+    using namespace vtkGlfwOpenGLRenderWindow_detail;
+    auto wnd = this->WindowId;
+    glfwSetWindowUserPointer(wnd, this);
+    glfwSetWindowSizeCallback(wnd, wnSizeCallback);
+    glfwSetWindowPosCallback(wnd, wnPosCallback);
+    glfwSetFramebufferSizeCallback(wnd, fbSizeCallback);
+    glfwSetWindowContentScaleCallback(wnd, contentScaleCallback);
+    glfwSetWindowFocusCallback(wnd, focusCallback);
+    glfwSetWindowIconifyCallback(wnd, iconifyCallback);
+    glfwSetWindowRefreshCallback(wnd, refreshCallback);
+
+    if (this->Position[0] >= 0 && this->Position[1] >= 0) {
+      glfwSetWindowPos(wnd, this->Position[0], this->Position[1]);
+    }
+    this->Mapped = this->ShowWindow;
+    this->HiddenSince = glfwGetTime();
+
+    // seed the geometry cache, the callbacks keep it current from here on
+    glfwGetWindowSize(wnd, this->Size, this->Size + 1);
+    glfwGetWindowPos(wnd, this->Position, this->Position + 1);
+    glfwGetFramebufferSize(
+      wnd, this->FramebufferSize, this->FramebufferSize + 1);
+    glfwGetWindowContentScale(wnd, this->ContentScale, this->ContentScale + 1);
+    this->UpdateScreenInfo();
+    this->Focused = glfwGetWindowAttrib(wnd, GLFW_FOCUSED) != 0;
+    this->Iconified = glfwGetWindowAttrib(wnd, GLFW_ICONIFIED) != 0;
+
+    if (this->FullScreen) {
+      this->ApplyFullScreen();
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+// Refresh the cached screen size and DPI from the monitor the window is on.
+void
+vtkGlfwOpenGLRenderWindow::UpdateScreenInfo()
+{
+  GLFWmonitor* mon = this->FindWindowMonitor();
+  const GLFWvidmode* mode = mon ? glfwGetVideoMode(mon) : nullptr;
+  if (!mode) {
+    return;
+  }
+  this->ScreenSize[0] = mode->width;
+  this->ScreenSize[1] = mode->height;
+
+  int wmm(0), hmm(0);
+  glfwGetMonitorPhysicalSize(mon, &wmm, &hmm);
+  if (wmm <= 0 || hmm <= 0) {
+    return;
+  }
+  float dpi = (float)mode->width * (float)mode->height /
+              ((float)wmm * (float)hmm * 0.0393701f * 0.0393701f);
+  float xs(0), ys(0);
+  glfwGetMonitorContentScale(mon, &xs, &ys);
+  vtkDebugMacro(<< "Pixels " << mode->width << "x" << mode->height);
+  vtkDebugMacro(<< "Screen " << wmm << "x" << hmm << "(mm)");
+  vtkDebugMacro(<< "Red" << mode->redBits);
+  vtkDebugMacro(<< "Blue" << mode->blueBits);
+  vtkDebugMacro(<< "Green" << mode->greenBits);
+  vtkDebugMacro(<< "Refresh-Rate" << mode->refreshRate);
+  vtkDebugMacro(<< "Native" << dpi << "DPI");
+  vtkDebugMacro(<< "Current" << xs * dpi << "DPI");
+  vtkDebugMacro(<< "x-scale" << xs);
+  vtkDebugMacro(<< "y-scale" << ys);
+  this->SetDPI(xs * dpi);
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwOpenGLRenderWindow::OnSize(int w, int h)
+{
+  // update the cache first, so the interactor's UpdateSize() finds the
+  // window already at this size and does not resize it again
+  this->vtkOpenGLRenderWindow::SetSize(w, h);
+
+  auto iren = this->Interactor;
+  if (iren && iren->IsA("vtkGlfwRenderWindowInteractor")) {
+    static_cast<vtkGlfwRenderWindowInteractor*>(iren)->OnSize(
+      this->WindowId, w, h);
+  }
+}
+
+void
+vtkGlfwOpenGLRenderWindow::OnPosition(int x, int y)
+{
+  if (this->Position[0] == x && this->Position[1] == y) {
+    return;
+  }
+  this->Position[0] = x;
+  this->Position[1] = y;
+  this->Modified();
+  this->UpdateScreenInfo();
+}
+
+void
+vtkGlfwOpenGLRenderWindow::OnFramebufferSize(int w, int h)
+{
+  this->FramebufferSize[0] = w;
+  this->FramebufferSize[1] = h;
+}
+
+void
+vtkGlfwOpenGLRenderWindow::OnContentScale(float xs, float ys)
+{
+  this->ContentScale[0] = xs;
+  this->ContentScale[1] = ys;
+  this->UpdateScreenInfo();
+}
+
+void
+vtkGlfwOpenGLRenderWindow::OnFocus(int focused)
+{
+  this->Focused = focused != 0;
+  if (this->Focused) {
+    this->RenderDeferred();
+  }
+}
+
+void
+vtkGlfwOpenGLRenderWindow::OnIconify(int iconified)
+{
+  this->Iconified = iconified != 0;
+  if (this->Iconified) {
+    this->HiddenSince = glfwGetTime();
+  } else if (this->Trimmed) {
+    this->Render();
+  } else {
+    this->RenderDeferred();
+  }
+}
+
+void
+vtkGlfwOpenGLRenderWindow::OnRefresh()
+{
+  // the system lost the window contents, e.g. it was uncovered
+  this->Render();
+}
+
+//------------------------------------------------------------------------------
+double
+vtkGlfwOpenGLRenderWindow::GetThrottleDelay()
+{
+  if (!this->WindowId) {
+    return 0.0;
+  }
+  if (this->Iconified && this->PauseWhenIconified) {
+    return -1.0;
+  }
+  // hidden windows render offscreen on demand and are never capped
+  if (this->Focused || !this->Mapped || this->UnfocusedFrameRate <= 0.0) {
+    return 0.0;
+  }
+  double due = this->LastRenderTime + 1.0 / this->UnfocusedFrameRate;
+  return std::max(0.0, due - glfwGetTime());
+}
+
+void
+vtkGlfwOpenGLRenderWindow::Render()
+{
+  if (this->GetThrottleDelay() != 0.0) {
+    this->DeferredRender = true;
+    return;
+  }
+  VTK_GLFW_TRACE_SCOPE("Render");
+  this->DeferredRender = false;
+  const double start = glfwGetTime();
+  this->LastRenderTime = start;
+  this->Superclass::Render();
+  // the render created whatever a trim released
+  this->Trimmed = false;
+  if (!this->AbortRender) {
+    this->UpdateFrameTime(glfwGetTime() - start);
+  }
+}
+
+void
+vtkGlfwOpenGLRenderWindow::UpdateFrameTime(double seconds)
+{
+  const double weight = this->FrameTimeSmoothing;
+  this->LastFrameTime = seconds;
+  if (this->SmoothedFrameTime <= 0.0) {
+    this->SmoothedFrameTime = seconds;
+  } else {
+    this->SmoothedFrameTime += weight * (seconds - this->SmoothedFrameTime);
+  }
+
+  if (!this->FrameTimeGovernor || this->DesiredUpdateRate <= 0.0) {
+    return;
+  }
+
+  // whatever the renderers did not measure themselves: swap, readback,
+  // WindowFrameEvent observers
+  vtkRenderer* ren;
+  vtkCollectionSimpleIterator rit;
+  double measured = 0.0;
+  int count = 0;
+  this->Renderers->InitTraversal(rit);
+  while ((ren = this->Renderers->GetNextRenderer(rit))) {
+    measured += ren->GetLastRenderTimeInSeconds();
+    ++count;
+  }
+  if (count == 0) {
+    return;
+  }
+  double overhead = std::max(0.0, seconds - measured);
+  this->SmoothedFrameOverhead +=
+    weight * (overhead - this->SmoothedFrameOverhead);
+
+  // the props get what is left of the frame, but never less than a tenth
+  const double target = 1.0 / this->DesiredUpdateRate;
+  const double budget =
+    std::max(target - this->SmoothedFrameOverhead, 0.1 * target);
+  this->Renderers->InitTraversal(rit);
+  while ((ren = this->Renderers->GetNextRenderer(rit))) {
+    ren->SetAllocatedRenderTime(budget / count);
+  }
+}
+
+double
+vtkGlfwOpenGLRenderWindow::GetDeferredRenderDelay()
+{
+  return this->DeferredRender ? this->GetThrottleDelay() : -1.0;
+}
+
+bool
+vtkGlfwOpenGLRenderWindow::RenderDeferred()
+{
+  if (this->GetDeferredRenderDelay() != 0.0) {
+    return false;
+  }
+  this->Render();
+  return true;
+}
+
+vtkIdType
+vtkGlfwOpenGLRenderWindow::TrimResources()
+{
+  if (!this->WindowId || this->Trimmed) {
+    return 0;
+  }
+  VTK_GLFW_TRACE_SCOPE("TrimResources");
+  using namespace vtkGlfwOpenGLRenderWindow_detail;
+  this->PushContext();
+  const GLint before = availableVideoMemory();
+  this->CleanUpRenderers();
+  // usually gone with the renderers already, but they are the bulk of it
+  this->GetRenderFramebuffer()->ReleaseGraphicsResources(this);
+  this->GetDisplayFramebuffer()->ReleaseGraphicsResources(this);
+  glFinish();
+  const GLint after = availableVideoMemory();
+  this->PopContext();
+
+  this->Trimmed = true;
+  this->ReclaimedMemory =
+    (before >= 0 && after >= 0) ? std::max(0, after - before) : 0;
+  vtkDebugMacro(<< "Trimmed graphics resources, reclaimed "
+                << this->ReclaimedMemory << " KiB");
+  return this->ReclaimedMemory;
+}
+
+double
+vtkGlfwOpenGLRenderWindow::GetTrimResourcesDelay()
+{
+  const bool hidden = this->Iconified || !this->Mapped;
+  if (!this->WindowId || !hidden || this->Trimmed || this->TrimDelay < 0.0) {
+    return -1.0;
   }
+  // hidden windows may still render offscreen, which keeps them resident
+  double due =
+    std::max(this->HiddenSince, this->LastRenderTime) + this->TrimDelay;
+  return std::max(0.0, due - glfwGetTime());
+}
+
+bool
+vtkGlfwOpenGLRenderWindow::TrimResourcesIfDue()
+{
+  if (this->GetTrimResourcesDelay() != 0.0) {
+    return false;
+  }
+  this->TrimResources();
+  return true;
 }
 
 // Initialize the rendering window.
 void
 vtkGlfwOpenGLRenderWindow::Initialize()
 {
-  if (!glfwInit())
-    vtkErrorMacro(<< "Error initializing GLFW3 ");
+  auto start = std::chrono::steady_clock::now();
+  const bool created = !this->WindowId;
+  if (!this->WindowId) {
+    using namespace vtkGlfwOpenGLRenderWindow_detail;
+    for (int backend : backendCandidates(this->Backend)) {
+      if (this->TryBackend(backend)) {
+        break;
+      }
+      vtkDebugMacro(<< "The " << backendName(backend)
+                    << " backend is not available");
+    }
+  }
+
+  if (!this->ContextId) {
+    this->ContextId = glfwGetCurrentContext();
+  }
+  if (!this->ContextId) {
+    vtkErrorMacro("Unable to create GLFW3 opengl context");
+    return;
+  }
+  this->OpenGLInit();
+
+  if (this->StartupTime <= 0.0) {
+    this->StartupTime = std::chrono::duration<double>(
+                          std::chrono::steady_clock::now() - start)
+                          .count();
+    vtkDebugMacro(
+      << "Started on the "
+      << vtkGlfwOpenGLRenderWindow_detail::backendName(this->ActiveBackend)
+      << " backend in " << this->StartupTime * 1000.0 << " ms");
+  }
+
+  vtkGlfwShaderBinaryCache* cache = this->GetShaderBinaryCache();
+  if (created && this->WarmUpShaders && cache) {
+    // links on the upload thread while the first frames render
+    cache->WarmUp(this->GetUploadContext(), this->MaximumWarmUpPrograms);
+  }
+}
+
+bool
+vtkGlfwOpenGLRenderWindow::TryBackend(int backend)
+{
+  const bool headless = backend != BACKEND_DISPLAY;
+#ifdef GLFW_PLATFORM_NULL
+  // only takes effect if GLFW is not running yet
+  glfwInitHint(GLFW_PLATFORM,
+               headless ? GLFW_PLATFORM_NULL : GLFW_ANY_PLATFORM);
+#endif
+  if (!glfwInit()) {
+    return false;
+  }
+#ifdef GLFW_PLATFORM_NULL
+  // an earlier display-less window decided the platform for the process
+  if (!headless && glfwGetPlatform() == GLFW_PLATFORM_NULL) {
+    return false;
+  }
+#endif
+
+  this->SetContextHints(backend);
+
+  bool savedShow = this->ShowWindow;
+  bool savedOffScreen = this->UseOffScreenBuffers;
+  if (headless) {
+    // nothing to show, render into the offscreen buffers instead
+    this->ShowWindow = false;
+    this->SetUseOffScreenBuffers(true);
+  }
+  this->ActiveBackend = backend;
+  this->CreateAWindow();
+  if (!this->WindowId) {
+    this->ActiveBackend = BACKEND_AUTO;
+    this->ShowWindow = savedShow;
+    this->SetUseOffScreenBuffers(savedOffScreen);
+    return false;
+  }
+  return true;
+}
 
+void
+vtkGlfwOpenGLRenderWindow::SetContextHints(int backend)
+{
   glfwWindowHint(GLFW_SAMPLES, 0);
 #ifdef GL_ES_VERSION_3_0
   glfwWindowHint(GLFW_CLIENT_API, GLFW_OPENGL_ES_API);
@@ -246,22 +865,15 @@ vtkGlfwOpenGLRenderWindow::Initialize()
   glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 0);
   glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 #else
+  glfwWindowHint(GLFW_CLIENT_API, GLFW_OPENGL_API);
   glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
   glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 2);
   glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 #endif
-
-  if (!this->WindowId) {
-    this->CreateAWindow();
-  }
-
-  if (!this->ContextId) {
-    this->ContextId = glfwGetCurrentContext();
-  }
-  if (!this->ContextId) {
-    vtkErrorMacro("Unable to create GLFW3 opengl context");
-  }
-  this->OpenGLInit();
+  glfwWindowHint(GLFW_CONTEXT_CREATION_API,
+                 backend == BACKEND_EGL      ? GLFW_EGL_CONTEXT_API
+                 : backend == BACKEND_OSMESA ? GLFW_OSMESA_CONTEXT_API
+                                             : GLFW_NATIVE_CONTEXT_API);
 }
 
 void
@@ -273,51 +885,48 @@ vtkGlfwOpenGLRenderWindow::Finalize()
 void
 vtkGlfwOpenGLRenderWindow::DestroyWindow()
 {
+  if (this->UploadContext) {
+    if (vtkGlfwShaderBinaryCache* cache = this->GetShaderBinaryCache()) {
+      cache->CancelWarmUp();
+    }
+    // leftover uploads are deleted through our context
+    this->MakeCurrent();
+    this->UploadContext->Stop();
+    this->UploadContext->Delete();
+    this->UploadContext = nullptr;
+  }
   this->Clean();
   if (this->WindowId) {
-    auto wnd = static_cast<GLFWwindow*>(this->WindowId);
     glfwDestroyWindow(this->WindowId);
     this->WindowId = nullptr;
   }
+  this->Mapped = 0;
+  this->Focused = false;
+  this->Iconified = false;
+  this->DeferredRender = false;
+  this->ActiveBackend = BACKEND_AUTO;
+  this->Trimmed = false;
 }
 
-// Get the current size of the window.
+// Get the current size of the window. The size callback keeps the ivar
+// current, offscreen rendering may also set it to size the framebuffers.
 int*
 vtkGlfwOpenGLRenderWindow::GetSize(void)
 {
-  // if we aren't mapped then just return the ivar
-  if (this->WindowId && this->Mapped) {
-    auto wnd = static_cast<GLFWwindow*>(this->WindowId);
-    glfwGetWindowSize(wnd, this->Size, this->Size + 1);
-  }
-
-  return this->vtkOpenGLRenderWindow::GetSize();
+  return this->Size;
 }
 
-// Get the size of the whole screen.
+// Get the size of the screen the window is on.
 int*
 vtkGlfwOpenGLRenderWindow::GetScreenSize(void)
 {
-  auto wnd = static_cast<GLFWwindow*>(this->WindowId);
-  GLFWmonitor* mon = glfwGetWindowMonitor(wnd);
-  const GLFWvidmode* mode = glfwGetVideoMode(mon);
-  this->Size[0] = mode->width;
-  this->Size[1] = mode->height;
-  return this->Size;
+  return this->ScreenSize;
 }
 
 // Get the position in screen coordinates of the window.
 int*
 vtkGlfwOpenGLRenderWindow::GetPosition(void)
 {
-  // if we aren't mapped then just return the ivar
-  if (!this->Mapped) {
-    return this->Position;
-  }
-
-  auto wnd = static_cast<GLFWwindow*>(this->WindowId);
-  //  Find the current window position
-  glfwGetWindowPos(wnd, this->Position, this->Position + 1);
   return this->Position;
 }
 
@@ -329,21 +938,211 @@ vtkGlfwOpenGLRenderWindow::SetFullScreen(vtkTypeBool arg)
     return;
   }
 
-  if (!this->Mapped) {
+  this->FullScreen = arg;
+  this->ApplyFullScreen();
+  this->Modified();
+}
+
+void
+vtkGlfwOpenGLRenderWindow::SetFullScreenMode(int mode)
+{
+  mode = (mode == FULLSCREEN_BORDERLESS) ? mode : FULLSCREEN_EXCLUSIVE;
+  if (this->FullScreenMode == mode) {
     return;
   }
 
-  // set the mode
-  this->FullScreen = arg;
-  auto wnd = static_cast<GLFWwindow*>(this->WindowId);
-  GLFWmonitor* mon = glfwGetWindowMonitor(wnd);
-  const GLFWvidmode* mode = glfwGetVideoMode(mon);
-  glfwSetWindowMonitor(
-    wnd, (arg ? mon : NULL), 0, 0, mode->width, mode->height, mode->refreshRate);
+  this->FullScreenMode = mode;
+  this->ApplyFullScreen();
+  this->Modified();
+}
+
+void
+vtkGlfwOpenGLRenderWindow::SetFullScreenMonitor(int index)
+{
+  if (this->FullScreenMonitor == index) {
+    return;
+  }
+
+  this->FullScreenMonitor = index;
+  this->ApplyFullScreen();
+  this->Modified();
+}
+
+void
+vtkGlfwOpenGLRenderWindow::SetFullScreenVideoMode(int width,
+                                                  int height,
+                                                  int refreshRate)
+{
+  if (this->FullScreenVideoMode[0] == width &&
+      this->FullScreenVideoMode[1] == height &&
+      this->FullScreenVideoMode[2] == refreshRate) {
+    return;
+  }
 
+  this->FullScreenVideoMode[0] = width;
+  this->FullScreenVideoMode[1] = height;
+  this->FullScreenVideoMode[2] = refreshRate;
+  this->ApplyFullScreen();
   this->Modified();
 }
 
+GLFWmonitor*
+vtkGlfwOpenGLRenderWindow::FindFullScreenMonitor()
+{
+  int count(0);
+  GLFWmonitor** monitors = glfwGetMonitors(&count);
+  if (!monitors || count == 0) {
+    return nullptr;
+  }
+  if (this->FullScreenMonitor >= 0) {
+    if (this->FullScreenMonitor < count) {
+      return monitors[this->FullScreenMonitor];
+    }
+    vtkWarningMacro(<< "No monitor " << this->FullScreenMonitor << ", only "
+                    << count << " connected. Using the primary monitor.");
+    return glfwGetPrimaryMonitor();
+  }
+  return this->FindWindowMonitor();
+}
+
+GLFWmonitor*
+vtkGlfwOpenGLRenderWindow::FindWindowMonitor()
+{
+  if (GLFWmonitor* current = glfwGetWindowMonitor(this->WindowId)) {
+    return current;
+  }
+
+  // the monitor that contains the center of the window
+  int count(0);
+  GLFWmonitor** monitors = glfwGetMonitors(&count);
+  int cx = this->Position[0] + this->Size[0] / 2;
+  int cy = this->Position[1] + this->Size[1] / 2;
+  for (int i = 0; i < count; ++i) {
+    int mx(0), my(0);
+    glfwGetMonitorPos(monitors[i], &mx, &my);
+    const GLFWvidmode* mode = glfwGetVideoMode(monitors[i]);
+    if (mode && cx >= mx && cx < mx + mode->width && cy >= my &&
+        cy < my + mode->height) {
+      return monitors[i];
+    }
+  }
+  return glfwGetPrimaryMonitor();
+}
+
+const GLFWvidmode*
+vtkGlfwOpenGLRenderWindow::FindFullScreenVideoMode(GLFWmonitor* mon)
+{
+  const GLFWvidmode* current = glfwGetVideoMode(mon);
+  int count(0);
+  const GLFWvidmode* modes = glfwGetVideoModes(mon, &count);
+  if (!current || !modes) {
+    return current;
+  }
+
+  int width = this->FullScreenVideoMode[0] > 0 ? this->FullScreenVideoMode[0]
+                                                : current->width;
+  int height = this->FullScreenVideoMode[1] > 0 ? this->FullScreenVideoMode[1]
+                                                 : current->height;
+  int rate = this->FullScreenVideoMode[2] > 0 ? this->FullScreenVideoMode[2]
+                                               : current->refreshRate;
+
+  // prefer the closest resolution, then the closest refresh rate, then the
+  // deepest color
+  const GLFWvidmode* best = current;
+  long bestScore[3] = { -1, 0, 0 };
+  for (int i = 0; i < count; ++i) {
+    const GLFWvidmode& mode = modes[i];
+    long score[3] = {
+      std::labs(long(mode.width) * mode.height - long(width) * height) +
+        std::labs(long(mode.width - width)) +
+        std::labs(long(mode.height - height)),
+      std::labs(long(mode.refreshRate - rate)),
+      -long(mode.redBits + mode.greenBits + mode.blueBits)
+    };
+    if (bestScore[0] < 0 || std::lexicographical_compare(
+                              score, score + 3, bestScore, bestScore + 3)) {
+      best = &mode;
+      std::copy(score, score + 3, bestScore);
+    }
+  }
+  return best;
+}
+
+void
+vtkGlfwOpenGLRenderWindow::ApplyFullScreen()
+{
+  if (!this->WindowId) {
+    return;
+  }
+
+  auto wnd = this->WindowId;
+  GLFWmonitor* exclusive = glfwGetWindowMonitor(wnd);
+  bool windowed = !exclusive && !this->BorderlessActive;
+
+  if (!this->FullScreen) {
+    if (windowed) {
+      return;
+    }
+    glfwSetWindowAttrib(wnd, GLFW_DECORATED, GLFW_TRUE);
+    this->BorderlessActive = false;
+    glfwSetWindowMonitor(wnd,
+                         NULL,
+                         this->WindowedGeometry[0],
+                         this->WindowedGeometry[1],
+                         this->WindowedGeometry[2],
+                         this->WindowedGeometry[3],
+                         GLFW_DONT_CARE);
+    return;
+  }
+
+  if (windowed) {
+    glfwGetWindowPos(wnd, this->WindowedGeometry, this->WindowedGeometry + 1);
+    glfwGetWindowSize(
+      wnd, this->WindowedGeometry + 2, this->WindowedGeometry + 3);
+  }
+
+  GLFWmonitor* mon = this->FindFullScreenMonitor();
+  if (!mon) {
+    vtkErrorMacro(<< "No monitor available for full screen.");
+    return;
+  }
+
+  // a disconnected or virtual monitor may report no video mode
+  const GLFWvidmode* mode = this->FullScreenMode == FULLSCREEN_BORDERLESS
+                              ? glfwGetVideoMode(mon)
+                              : this->FindFullScreenVideoMode(mon);
+  if (!mode) {
+    vtkErrorMacro(<< "No video mode available on monitor "
+                  << glfwGetMonitorName(mon) << " for full screen.");
+    // nothing was changed, so a windowed window stays windowed
+    if (windowed) {
+      this->FullScreen = 0;
+    }
+    return;
+  }
+
+  // glfwSetWindowMonitor moves the window between monitors and modes
+  // without touching its context, so nothing has to be uploaded again
+  if (this->FullScreenMode == FULLSCREEN_BORDERLESS) {
+    int mx(0), my(0);
+    glfwGetMonitorPos(mon, &mx, &my);
+    glfwSetWindowAttrib(wnd, GLFW_DECORATED, GLFW_FALSE);
+    glfwSetWindowMonitor(
+      wnd, NULL, mx, my, mode->width, mode->height, GLFW_DONT_CARE);
+    this->BorderlessActive = true;
+  } else {
+    if (this->BorderlessActive) {
+      glfwSetWindowAttrib(wnd, GLFW_DECORATED, GLFW_TRUE);
+      this->BorderlessActive = false;
+    }
+    glfwSetWindowMonitor(
+      wnd, mon, 0, 0, mode->width, mode->height, mode->refreshRate);
+    vtkDebugMacro(<< "Exclusive full screen on " << glfwGetMonitorName(mon)
+                  << " at " << mode->width << "x" << mode->height << "@"
+                  << mode->refreshRate << "Hz");
+  }
+}
+
 void
 vtkGlfwOpenGLRenderWindow::PrintSelf(ostream& os, vtkIndent indent)
 {
@@ -351,6 +1150,50 @@ vtkGlfwOpenGLRenderWindow::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "ContextId: " << this->ContextId << "\n";
   os << indent << "Window Id: " << this->WindowId << "\n";
+  os << indent << "MaximumTileSize: " << this->MaximumTileSize << "\n";
+  os << indent << "FullScreenMode: "
+     << (this->FullScreenMode == FULLSCREEN_BORDERLESS ? "Borderless"
+                                                       : "Exclusive")
+     << "\n";
+  os << indent << "SnapshotThreads: " << this->SnapshotThreads << "\n";
+  os << indent << "MaximumPendingSnapshots: " << this->MaximumPendingSnapshots
+     << "\n";
+  os << indent << "SnapshotCompressionLevel: "
+     << this->SnapshotCompressionLevel << "\n";
+  os << indent << "FullScreenMonitor: " << this->FullScreenMonitor << "\n";
+  os << indent << "FullScreenVideoMode: " << this->FullScreenVideoMode[0]
+     << "x" << this->FullScreenVideoMode[1] << "@"
+     << this->FullScreenVideoMode[2] << "\n";
+  os << indent << "Focused: " << this->Focused << "\n";
+  os << indent << "Iconified: " << this->Iconified << "\n";
+  os << indent << "PauseWhenIconified: " << this->PauseWhenIconified << "\n";
+  os << indent << "UnfocusedFrameRate: " << this->UnfocusedFrameRate << "\n";
+  os << indent << "FrameTimeGovernor: " << this->FrameTimeGovernor << "\n";
+  os << indent << "FrameTimeSmoothing: " << this->FrameTimeSmoothing << "\n";
+  os << indent << "SmoothedFrameTime: " << this->SmoothedFrameTime << "\n";
+  os << indent << "NumberOfFrames: " << this->NumberOfFrames << "\n";
+  os << indent << "Backend: "
+     << vtkGlfwOpenGLRenderWindow_detail::backendName(this->Backend) << "\n";
+  os << indent << "ActiveBackend: "
+     << vtkGlfwOpenGLRenderWindow_detail::backendName(this->ActiveBackend)
+     << "\n";
+  os << indent << "StartupTime: " << this->StartupTime << "\n";
+  os << indent << "NumberOfContextSwitches: "
+     << this->NumberOfContextSwitches << "\n";
+  os << indent << "TrimDelay: " << this->TrimDelay << "\n";
+  os << indent << "Trimmed: " << this->Trimmed << "\n";
+  os << indent << "ReclaimedMemory: " << this->ReclaimedMemory << "\n";
+  os << indent << "WarmUpShaders: " << this->WarmUpShaders << "\n";
+  os << indent << "ShowPerformanceHud: " << this->ShowPerformanceHud << "\n";
+  os << indent << "MaximumWarmUpPrograms: " << this->MaximumWarmUpPrograms
+     << "\n";
+}
+
+//------------------------------------------------------------------------------
+vtkGlfwShaderBinaryCache*
+vtkGlfwOpenGLRenderWindow::GetShaderBinaryCache()
+{
+  return vtkGlfwShaderBinaryCache::SafeDownCast(this->ShaderCache);
 }
 
 //------------------------------------------------------------------------------
@@ -368,3 +1211,365 @@ vtkGlfwOpenGLRenderWindow::ShowCursor()
   auto wnd = static_cast<GLFWwindow*>(this->WindowId);
   glfwSetInputMode(wnd, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
 }
+
+//------------------------------------------------------------------------------
+GLFWwindow*
+vtkGlfwOpenGLRenderWindow::CreateSharedContextWindow()
+{
+  if (!this->WindowId) {
+    return nullptr;
+  }
+  // hints are global and may have changed since Initialize(), a context
+  // only shares objects with one of the same API and creation API
+  glfwDefaultWindowHints();
+  this->SetContextHints(this->ActiveBackend);
+  glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+  GLFWwindow* shared = glfwCreateWindow(1, 1, "", NULL, this->WindowId);
+  glfwDefaultWindowHints();
+  if (!shared) {
+    vtkErrorMacro(<< "Unable to create a context shared with "
+                  << this->WindowId);
+  }
+  return shared;
+}
+
+//------------------------------------------------------------------------------
+vtkGlfwUploadContext*
+vtkGlfwOpenGLRenderWindow::GetUploadContext()
+{
+  if (!this->WindowId) {
+    return nullptr;
+  }
+  if (!this->UploadContext) {
+    this->UploadContext = vtkGlfwUploadContext::New();
+    if (!this->UploadContext->Start(this)) {
+      this->UploadContext->Delete();
+      this->UploadContext = nullptr;
+    }
+  }
+  return this->UploadContext;
+}
+
+//------------------------------------------------------------------------------
+bool
+vtkGlfwOpenGLRenderWindow::SaveSnapshot(const char* fileName)
+{
+  if (!fileName || !this->WindowId || this->Trimmed) {
+    return false;
+  }
+  if (!this->SnapshotWriter) {
+    this->SnapshotWriter = new vtkGlfwSnapshotWriter(
+      this->SnapshotThreads, this->MaximumPendingSnapshots);
+  }
+
+  const int width = this->Size[0];
+  const int height = this->Size[1];
+  if (width <= 0 || height <= 0) {
+    return false;
+  }
+  auto pixels = this->SnapshotWriter->AcquireBuffer(size_t(width) * height * 3);
+  if (!this->ReadFramePixels(pixels->data(), 3)) {
+    this->SnapshotWriter->ReleaseBuffer(std::move(pixels));
+    return false;
+  }
+
+  this->SnapshotWriter->Write(std::move(pixels),
+                              width,
+                              height,
+                              3,
+                              this->SnapshotCompressionLevel,
+                              fileName);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+bool
+vtkGlfwOpenGLRenderWindow::ReadFramePixels(unsigned char* data, int components)
+{
+  if (!this->WindowId || this->Trimmed || !data ||
+      (components != 3 && components != 4)) {
+    return false;
+  }
+
+  this->MakeCurrent();
+  auto ostate = this->GetState();
+  ostate->PushReadFramebufferBinding();
+  this->BindFrameReadBuffer();
+  ostate->vtkglPixelStorei(GL_PACK_ALIGNMENT, 1);
+  glReadPixels(0,
+               0,
+               this->Size[0],
+               this->Size[1],
+               components == 4 ? GL_RGBA : GL_RGB,
+               GL_UNSIGNED_BYTE,
+               data);
+  ostate->PopReadFramebufferBinding();
+  return true;
+}
+
+//------------------------------------------------------------------------------
+bool
+vtkGlfwOpenGLRenderWindow::ReadFrameDepth(float* data)
+{
+  if (!this->WindowId || this->Trimmed || !data) {
+    return false;
+  }
+
+  this->MakeCurrent();
+  auto ostate = this->GetState();
+  ostate->PushReadFramebufferBinding();
+  this->BindFrameReadBuffer();
+  ostate->vtkglPixelStorei(GL_PACK_ALIGNMENT, 4);
+  glReadPixels(0,
+               0,
+               this->Size[0],
+               this->Size[1],
+               GL_DEPTH_COMPONENT,
+               GL_FLOAT,
+               data);
+  ostate->PopReadFramebufferBinding();
+  return true;
+}
+
+//------------------------------------------------------------------------------
+bool
+vtkGlfwOpenGLRenderWindow::StartFrameReadback(bool depth)
+{
+  if (!this->WindowId || this->Trimmed) {
+    return false;
+  }
+  if (!this->PixelReadback) {
+    this->PixelReadback = new vtkGlfwPixelReadback(3);
+  }
+
+  this->MakeCurrent();
+  auto ostate = this->GetState();
+  ostate->PushReadFramebufferBinding();
+  this->BindFrameReadBuffer();
+  ostate->vtkglPixelStorei(GL_PACK_ALIGNMENT, 4);
+  bool queued = this->PixelReadback->Read(this->Size[0], this->Size[1], depth);
+  ostate->PopReadFramebufferBinding();
+  return queued;
+}
+
+//------------------------------------------------------------------------------
+bool
+vtkGlfwOpenGLRenderWindow::MapFrameReadback(FramePixels& pixels, bool wait)
+{
+  auto readback = this->PixelReadback;
+  if (!this->WindowId || !readback || !readback->GetNumberOfPendingReads()) {
+    return false;
+  }
+
+  this->MakeCurrent();
+  if (!wait && !readback->IsOldestReady()) {
+    return false;
+  }
+  vtkGlfwPixelReadback::Pixels mapped;
+  if (!readback->MapOldest(mapped)) {
+    readback->PopOldest();
+    return false;
+  }
+  pixels.Width = mapped.Width;
+  pixels.Height = mapped.Height;
+  pixels.Color = mapped.Color;
+  pixels.Depth = mapped.Depth;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwOpenGLRenderWindow::FinishFrameReadback()
+{
+  if (this->WindowId && this->PixelReadback) {
+    this->MakeCurrent();
+    this->PixelReadback->PopOldest();
+  }
+}
+
+//------------------------------------------------------------------------------
+int
+vtkGlfwOpenGLRenderWindow::GetNumberOfFrameReadbacks()
+{
+  return this->PixelReadback ? this->PixelReadback->GetNumberOfPendingReads()
+                             : 0;
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwOpenGLRenderWindow::WaitForSnapshots()
+{
+  if (this->SnapshotWriter) {
+    this->SnapshotWriter->Wait();
+  }
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwOpenGLRenderWindow::BindFrameReadBuffer()
+{
+  // Frame() resolves the render framebuffer into the display framebuffer,
+  // for both onscreen and offscreen rendering.
+  this->GetDisplayFramebuffer()->Bind(GL_READ_FRAMEBUFFER);
+  this->GetDisplayFramebuffer()->ActivateReadBuffer(0);
+}
+
+//------------------------------------------------------------------------------
+bool
+vtkGlfwOpenGLRenderWindow::RenderTiled(int width,
+                                       int height,
+                                       const TileRowWriter& writer)
+{
+  if (width <= 0 || height <= 0 || !writer) {
+    vtkErrorMacro(<< "Invalid tiled render request " << width << "x"
+                  << height);
+    return false;
+  }
+
+  if (!this->WindowId) {
+    this->Initialize();
+  }
+  if (!this->WindowId) {
+    return false;
+  }
+  this->MakeCurrent();
+
+  GLint maxDims[2] = { 0, 0 };
+  glGetIntegerv(GL_MAX_VIEWPORT_DIMS, maxDims);
+  int maxTile[2] = { std::min(this->MaximumTileSize, int(maxDims[0])),
+                     std::min(this->MaximumTileSize, int(maxDims[1])) };
+
+  // The virtual image is tiles[i] * tileSize[i], which may exceed the
+  // requested size by less than one pixel per tile; the excess columns on
+  // the right and rows at the bottom are cropped.
+  int tiles[2] = { (width + maxTile[0] - 1) / maxTile[0],
+                   (height + maxTile[1] - 1) / maxTile[1] };
+  int tileSize[2] = { (width + tiles[0] - 1) / tiles[0],
+                      (height + tiles[1] - 1) / tiles[1] };
+  const size_t rowBytes = size_t(width) * 4;
+  const double kept[2] = { double(width) / (tiles[0] * tileSize[0]),
+                           double(height) / (tiles[1] * tileSize[1]) };
+
+  // save what we are about to change
+  int savedSize[2] = { this->Size[0], this->Size[1] };
+  int savedScale[2] = { this->TileScale[0], this->TileScale[1] };
+  double savedViewport[4] = { this->TileViewport[0],
+                              this->TileViewport[1],
+                              this->TileViewport[2],
+                              this->TileViewport[3] };
+  bool savedOffScreen = this->UseOffScreenBuffers;
+  vtkTypeBool savedSwap = this->SwapBuffers;
+
+  this->SetUseOffScreenBuffers(true);
+  this->SwapBuffers = 0;
+  this->vtkOpenGLRenderWindow::SetSize(tileSize[0], tileSize[1]);
+  this->SetTileScale(tiles[0], tiles[1]);
+
+  // squeeze the renderers into the part that is kept, so their aspects and
+  // camera centers are those of a width x height window
+  std::vector<double> savedViewports;
+  vtkRenderer* ren;
+  vtkCollectionSimpleIterator rit;
+  this->Renderers->InitTraversal(rit);
+  while ((ren = this->Renderers->GetNextRenderer(rit))) {
+    const double* vp = ren->GetViewport();
+    savedViewports.insert(savedViewports.end(), vp, vp + 4);
+    ren->SetViewport(vp[0] * kept[0],
+                     1.0 - (1.0 - vp[1]) * kept[1],
+                     vp[2] * kept[0],
+                     1.0 - (1.0 - vp[3]) * kept[1]);
+  }
+
+  // two pixel pack buffers, so reading back tile N overlaps rendering N+1
+  vtkGlfwPixelReadback readback(2);
+
+  // one band of tiles, in OpenGL (bottom-up) row order
+  std::vector<unsigned char> band(rowBytes * tileSize[1]);
+  bool ok = true;
+
+  // copy a finished tile into the band and, once the band is complete,
+  // hand its rows to the writer top row first
+  auto drain = [&](int tile) {
+    int tx = tile % tiles[0];
+    int ty = tiles[1] - 1 - tile / tiles[0];
+    vtkGlfwPixelReadback::Pixels tilePixels;
+    if (!readback.MapOldest(tilePixels)) {
+      readback.PopOldest();
+      return false;
+    }
+    const unsigned char* pixels = tilePixels.Color;
+    int x0 = tx * tileSize[0];
+    int columns = std::min(tileSize[0], width - x0);
+    for (int r = 0; r < tileSize[1]; ++r) {
+      std::copy_n(pixels + size_t(r) * tileSize[0] * 4,
+                  size_t(columns) * 4,
+                  band.data() + r * rowBytes + size_t(x0) * 4);
+    }
+    readback.PopOldest();
+
+    if (tx != tiles[0] - 1) {
+      return true;
+    }
+    int firstRow = (tiles[1] - 1 - ty) * tileSize[1];
+    for (int r = tileSize[1] - 1; r >= 0; --r) {
+      int row = firstRow + tileSize[1] - 1 - r;
+      if (row >= height) {
+        break;
+      }
+      if (!writer(row, band.data() + r * rowBytes)) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  const int numTiles = tiles[0] * tiles[1];
+  this->RenderingTiles = true;
+  for (int tile = 0; ok && tile < numTiles; ++tile) {
+    // bands are rendered top first so rows can be streamed in order
+    int tx = tile % tiles[0];
+    int ty = tiles[1] - 1 - tile / tiles[0];
+    this->SetTileViewport(double(tx) / tiles[0],
+                          double(ty) / tiles[1],
+                          double(tx + 1) / tiles[0],
+                          double(ty + 1) / tiles[1]);
+    // tiles must not be throttled away
+    this->Superclass::Render();
+
+    this->MakeCurrent();
+    auto ostate = this->GetState();
+    ostate->PushReadFramebufferBinding();
+    this->BindFrameReadBuffer();
+    ostate->vtkglPixelStorei(GL_PACK_ALIGNMENT, 1);
+    readback.Read(tileSize[0], tileSize[1], false);
+    ostate->PopReadFramebufferBinding();
+
+    if (tile > 0) {
+      ok = drain(tile - 1);
+    }
+  }
+  this->RenderingTiles = false;
+  if (ok) {
+    ok = drain(numTiles - 1);
+  }
+
+  readback.ReleaseGraphicsResources();
+
+  const double* vp = savedViewports.data();
+  this->Renderers->InitTraversal(rit);
+  while ((ren = this->Renderers->GetNextRenderer(rit))) {
+    ren->SetViewport(vp[0], vp[1], vp[2], vp[3]);
+    vp += 4;
+  }
+  this->SetTileScale(savedScale[0], savedScale[1]);
+  this->SetTileViewport(savedViewport);
+  this->vtkOpenGLRenderWindow::SetSize(savedSize[0], savedSize[1]);
+  this->SwapBuffers = savedSwap;
+  this->SetUseOffScreenBuffers(savedOffScreen);
+
+  if (!ok) {
+    vtkErrorMacro(<< "Tiled render of " << width << "x" << height
+                  << " was aborted");
+  }
+  return ok;
+}
@@ -0,0 +1,482 @@
+#include "vtkGlfwPerformanceHud.h"
+
+#include "vtk_glew.h"
+#include <GLFW/glfw3.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+// 5x7 glyphs, one row per byte with the leftmost pixel in bit 4
+const char* const GlyphSet = " 0123456789./-ACEFGMNPRSTUVX";
+const unsigned char Glyphs[][7] = {
+  { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, // space
+  { 0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E }, // 0
+  { 0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E }, // 1
+  { 0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F }, // 2
+  { 0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E }, // 3
+  { 0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02 }, // 4
+  { 0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E }, // 5
+  { 0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E }, // 6
+  { 0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08 }, // 7
+  { 0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E }, // 8
+  { 0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C }, // 9
+  { 0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C }, // .
+  { 0x01, 0x01, 0x02, 0x04, 0x08, 0x10, 0x10 }, // /
+  { 0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00 }, // -
+  { 0x0E, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11 }, // A
+  { 0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E }, // C
+  { 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F }, // E
+  { 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10 }, // F
+  { 0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F }, // G
+  { 0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11 }, // M
+  { 0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11 }, // N
+  { 0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10 }, // P
+  { 0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11 }, // R
+  { 0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E }, // S
+  { 0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04 }, // T
+  { 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E }, // U
+  { 0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04 }, // V
+  { 0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11 }, // X
+};
+const int NumberOfGlyphs = sizeof(Glyphs) / sizeof(Glyphs[0]);
+const int GlyphWidth = 5;
+const int GlyphHeight = 7;
+// rows padded to a multiple of 4 bytes, the default unpack alignment
+const int AtlasWidth = (NumberOfGlyphs * GlyphWidth + 3) / 4 * 4;
+
+// panel, graph and five lines of up to 16 characters
+const size_t MaximumVertices = 2048;
+
+#ifdef GL_ES_VERSION_3_0
+#define VTK_GLFW_HUD_VERSION "#version 300 es\nprecision mediump float;\n"
+#else
+#define VTK_GLFW_HUD_VERSION "#version 150\n"
+#endif
+
+const char* const VertexShader = VTK_GLFW_HUD_VERSION
+  "in vec4 vertex;\n"
+  "in vec4 color;\n"
+  "uniform vec2 viewport;\n"
+  "out vec2 uv;\n"
+  "out vec4 tint;\n"
+  "void main()\n"
+  "{\n"
+  "  uv = vertex.zw;\n"
+  "  tint = color;\n"
+  "  gl_Position = vec4(vertex.x / viewport.x * 2.0 - 1.0,\n"
+  "                     1.0 - vertex.y / viewport.y * 2.0, 0.0, 1.0);\n"
+  "}\n";
+
+// texture coordinates are in texels, negative for solid quads
+const char* const FragmentShader = VTK_GLFW_HUD_VERSION
+  "in vec2 uv;\n"
+  "in vec4 tint;\n"
+  "uniform sampler2D atlas;\n"
+  "out vec4 fragColor;\n"
+  "void main()\n"
+  "{\n"
+  "  float a = uv.x < 0.0 ? 1.0 : texelFetch(atlas, ivec2(uv), 0).r;\n"
+  "  fragColor = vec4(tint.rgb, tint.a * a);\n"
+  "}\n";
+
+const unsigned char PanelColor[4] = { 0, 0, 0, 160 };
+const unsigned char TextColor[4] = { 255, 255, 255, 255 };
+const unsigned char GoodColor[4] = { 80, 200, 80, 255 };
+const unsigned char SlowColor[4] = { 230, 200, 60, 255 };
+const unsigned char BadColor[4] = { 230, 70, 60, 255 };
+const unsigned char LineColor[4] = { 255, 255, 255, 96 };
+
+// the graph spans two 60 Hz frames, the line marks one
+const float GraphRange = 2.0f / 60.0f;
+
+GLuint
+compileShader(GLenum type, const char* source)
+{
+  GLuint shader = glCreateShader(type);
+  glShaderSource(shader, 1, &source, nullptr);
+  glCompileShader(shader);
+  GLint compiled = 0;
+  glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+  if (!compiled) {
+    glDeleteShader(shader);
+    return 0;
+  }
+  return shader;
+}
+}
+
+//------------------------------------------------------------------------------
+vtkGlfwPerformanceHud::vtkGlfwPerformanceHud()
+  : Program(0)
+  , VertexArray(0)
+  , Buffer(0)
+  , Atlas(0)
+  , ViewportLocation(-1)
+  , AtlasLocation(-1)
+  , Queries{}
+  , Head(0)
+  , Pending(0)
+  , Active(false)
+  , GPUTime(-1.0)
+  , Graph{}
+  , GraphIndex(0)
+  , SampleTime(-1.0)
+{
+  this->Vertices.reserve(MaximumVertices);
+}
+
+//------------------------------------------------------------------------------
+vtkGlfwPerformanceHud::~vtkGlfwPerformanceHud() = default;
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwPerformanceHud::BeginFrame()
+{
+#ifndef GL_ES_VERSION_3_0
+  if (this->Active || this->Pending == NumberOfQueries) {
+    return;
+  }
+  if (!this->Queries[0]) {
+    glGenQueries(NumberOfQueries, this->Queries);
+  }
+  int slot = (this->Head + this->Pending) % NumberOfQueries;
+  glBeginQuery(GL_TIME_ELAPSED, this->Queries[slot]);
+  this->Active = true;
+#endif
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwPerformanceHud::EndFrame()
+{
+#ifndef GL_ES_VERSION_3_0
+  if (!this->Active) {
+    return;
+  }
+  glEndQuery(GL_TIME_ELAPSED);
+  this->Active = false;
+  ++this->Pending;
+#endif
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwPerformanceHud::CollectQueries()
+{
+#ifndef GL_ES_VERSION_3_0
+  while (this->Pending > 0) {
+    GLuint query = this->Queries[this->Head];
+    GLint available = 0;
+    glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available) {
+      break;
+    }
+    GLuint64 nanoseconds = 0;
+    glGetQueryObjectui64v(query, GL_QUERY_RESULT, &nanoseconds);
+    double seconds = nanoseconds * 1e-9;
+    this->GPUTime = this->GPUTime < 0.0
+                      ? seconds
+                      : this->GPUTime + 0.25 * (seconds - this->GPUTime);
+    this->Head = (this->Head + 1) % NumberOfQueries;
+    --this->Pending;
+  }
+#endif
+}
+
+//------------------------------------------------------------------------------
+bool
+vtkGlfwPerformanceHud::CreateGraphicsResources()
+{
+  if (this->Program) {
+    return true;
+  }
+  GLuint vertex = compileShader(GL_VERTEX_SHADER, VertexShader);
+  GLuint fragment = compileShader(GL_FRAGMENT_SHADER, FragmentShader);
+  GLint linked = 0;
+  GLuint program = glCreateProgram();
+  if (vertex && fragment) {
+    glAttachShader(program, vertex);
+    glAttachShader(program, fragment);
+    glBindAttribLocation(program, 0, "vertex");
+    glBindAttribLocation(program, 1, "color");
+    glLinkProgram(program);
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    glDetachShader(program, vertex);
+    glDetachShader(program, fragment);
+  }
+  glDeleteShader(vertex);
+  glDeleteShader(fragment);
+  if (!linked) {
+    glDeleteProgram(program);
+    return false;
+  }
+  this->Program = program;
+  this->ViewportLocation = glGetUniformLocation(program, "viewport");
+  this->AtlasLocation = glGetUniformLocation(program, "atlas");
+
+  std::vector<unsigned char> pixels(AtlasWidth * GlyphHeight, 0);
+  for (int glyph = 0; glyph < NumberOfGlyphs; ++glyph) {
+    for (int row = 0; row < GlyphHeight; ++row) {
+      for (int column = 0; column < GlyphWidth; ++column) {
+        if (Glyphs[glyph][row] & (0x10 >> column)) {
+          pixels[row * AtlasWidth + glyph * GlyphWidth + column] = 255;
+        }
+      }
+    }
+  }
+  glGenTextures(1, &this->Atlas);
+  glBindTexture(GL_TEXTURE_2D, this->Atlas);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+  glTexImage2D(GL_TEXTURE_2D,
+               0,
+               GL_R8,
+               AtlasWidth,
+               GlyphHeight,
+               0,
+               GL_RED,
+               GL_UNSIGNED_BYTE,
+               pixels.data());
+
+  glGenVertexArrays(1, &this->VertexArray);
+  glBindVertexArray(this->VertexArray);
+  glGenBuffers(1, &this->Buffer);
+  glBindBuffer(GL_ARRAY_BUFFER, this->Buffer);
+  glBufferData(
+    GL_ARRAY_BUFFER, MaximumVertices * sizeof(Vertex), nullptr, GL_STREAM_DRAW);
+  glEnableVertexAttribArray(0);
+  glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), nullptr);
+  glEnableVertexAttribArray(1);
+  glVertexAttribPointer(1,
+                        4,
+                        GL_UNSIGNED_BYTE,
+                        GL_TRUE,
+                        sizeof(Vertex),
+                        reinterpret_cast<void*>(offsetof(Vertex, Color)));
+  return true;
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwPerformanceHud::ReleaseGraphicsResources()
+{
+  if (this->Program) {
+    glDeleteProgram(this->Program);
+    glDeleteTextures(1, &this->Atlas);
+    glDeleteBuffers(1, &this->Buffer);
+    glDeleteVertexArrays(1, &this->VertexArray);
+  }
+  this->Program = 0;
+  this->Atlas = 0;
+  this->Buffer = 0;
+  this->VertexArray = 0;
+#ifndef GL_ES_VERSION_3_0
+  if (this->Queries[0]) {
+    if (this->Active) {
+      glEndQuery(GL_TIME_ELAPSED);
+    }
+    glDeleteQueries(NumberOfQueries, this->Queries);
+  }
+#endif
+  std::fill(this->Queries, this->Queries + NumberOfQueries, 0u);
+  this->Head = 0;
+  this->Pending = 0;
+  this->Active = false;
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwPerformanceHud::UpdateText(const Counters& counters)
+{
+  const double now = glfwGetTime();
+  if (this->SampleTime >= 0.0 && now - this->SampleTime < 0.5) {
+    return;
+  }
+  const double elapsed = now - this->SampleTime;
+  const bool first = this->SampleTime < 0.0;
+  auto rate = [&](vtkIdType current, vtkIdType previous) {
+    return first ? 0.0 : (current - previous) / elapsed;
+  };
+
+  char line[32];
+  this->Lines.clear();
+  snprintf(line,
+           sizeof(line),
+           "FPS %.1f",
+           rate(counters.Frames, this->Sampled.Frames));
+  this->Lines.push_back(line);
+  snprintf(line, sizeof(line), "FRAME %.1f MS", counters.FrameTime * 1e3);
+  this->Lines.push_back(line);
+  if (this->GPUTime >= 0.0) {
+    snprintf(line, sizeof(line), "GPU %.1f MS", this->GPUTime * 1e3);
+  } else {
+    snprintf(line, sizeof(line), "GPU -");
+  }
+  this->Lines.push_back(line);
+  if (counters.Events >= 0) {
+    snprintf(line,
+             sizeof(line),
+             "EVENTS %.0f/S",
+             rate(counters.Events, this->Sampled.Events));
+  } else {
+    snprintf(line, sizeof(line), "EVENTS -");
+  }
+  this->Lines.push_back(line);
+  snprintf(line,
+           sizeof(line),
+           "CTX %.0f/S",
+           rate(counters.ContextSwitches, this->Sampled.ContextSwitches));
+  this->Lines.push_back(line);
+
+  this->SampleTime = now;
+  this->Sampled = counters;
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwPerformanceHud::AddQuad(float x0,
+                               float y0,
+                               float x1,
+                               float y1,
+                               const unsigned char color[4],
+                               float u0,
+                               float v0,
+                               float u1,
+                               float v1)
+{
+  if (this->Vertices.size() + 6 > MaximumVertices) {
+    return;
+  }
+  Vertex corners[4] = {
+    { x0, y0, u0, v0, {} },
+    { x1, y0, u1, v0, {} },
+    { x1, y1, u1, v1, {} },
+    { x0, y1, u0, v1, {} },
+  };
+  for (Vertex& corner : corners) {
+    std::copy(color, color + 4, corner.Color);
+  }
+  for (int index : { 0, 1, 2, 0, 2, 3 }) {
+    this->Vertices.push_back(corners[index]);
+  }
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwPerformanceHud::AddText(float x,
+                               float y,
+                               float size,
+                               const std::string& text)
+{
+  for (char c : text) {
+    const char* found = strchr(GlyphSet, c);
+    if (c && found) {
+      float u = static_cast<float>((found - GlyphSet) * GlyphWidth);
+      this->AddQuad(x,
+                    y,
+                    x + GlyphWidth * size,
+                    y + GlyphHeight * size,
+                    TextColor,
+                    u,
+                    0.0f,
+                    u + GlyphWidth,
+                    static_cast<float>(GlyphHeight));
+    }
+    x += (GlyphWidth + 1) * size;
+  }
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwPerformanceHud::Draw(int width,
+                            int height,
+                            float scale,
+                            const Counters& counters)
+{
+  if (width <= 0 || height <= 0 || !this->CreateGraphicsResources()) {
+    return;
+  }
+  this->CollectQueries();
+  this->Graph[this->GraphIndex] = static_cast<float>(counters.FrameTime);
+  this->GraphIndex = (this->GraphIndex + 1) % GraphLength;
+  this->UpdateText(counters);
+
+  // layout in framebuffer pixels from the top left corner
+  const float size = 2.0f * std::max(1.0f, scale);
+  const float margin = 4.0f * size;
+  const float lineHeight = (GlyphHeight + 2) * size;
+  const float graphHeight = 20.0f * size;
+  const float barWidth = size;
+  const float panelWidth = std::max(GraphLength * barWidth, 16 * 6 * size);
+  const float textTop = 2.0f * margin;
+  const float graphTop = textTop + this->Lines.size() * lineHeight + size;
+  const float graphBottom = graphTop + graphHeight;
+
+  this->Vertices.clear();
+  this->AddQuad(margin,
+                margin,
+                2.0f * margin + panelWidth + margin,
+                graphBottom + margin,
+                PanelColor);
+  for (size_t i = 0; i < this->Lines.size(); ++i) {
+    float y = textTop + i * lineHeight;
+    this->AddText(2.0f * margin, y, size, this->Lines[i]);
+  }
+  for (int i = 0; i < GraphLength; ++i) {
+    // oldest on the left
+    float seconds = this->Graph[(this->GraphIndex + i) % GraphLength];
+    if (seconds <= 0.0f) {
+      continue;
+    }
+    float fraction = std::min(1.0f, seconds / GraphRange);
+    const unsigned char* color = seconds < 0.5f * GraphRange ? GoodColor
+                                 : seconds < GraphRange      ? SlowColor
+                                                             : BadColor;
+    float x = 2.0f * margin + i * barWidth;
+    this->AddQuad(x,
+                  graphBottom - fraction * graphHeight,
+                  x + barWidth,
+                  graphBottom,
+                  color);
+  }
+  const float budget = graphBottom - 0.5f * graphHeight;
+  this->AddQuad(2.0f * margin,
+                budget,
+                2.0f * margin + GraphLength * barWidth,
+                budget + std::max(1.0f, 0.5f * size),
+                LineColor);
+
+  // the bindings are restored, the caller owns the rest of the state
+  GLint program = 0, vertexArray = 0, arrayBuffer = 0;
+  GLint activeTexture = 0, texture = 0;
+  glGetIntegerv(GL_CURRENT_PROGRAM, &program);
+  glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &vertexArray);
+  glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &arrayBuffer);
+  glGetIntegerv(GL_ACTIVE_TEXTURE, &activeTexture);
+  glActiveTexture(GL_TEXTURE0);
+  glGetIntegerv(GL_TEXTURE_BINDING_2D, &texture);
+
+  glUseProgram(this->Program);
+  glUniform2f(this->ViewportLocation,
+              static_cast<float>(width),
+              static_cast<float>(height));
+  glUniform1i(this->AtlasLocation, 0);
+  glBindTexture(GL_TEXTURE_2D, this->Atlas);
+  glBindVertexArray(this->VertexArray);
+  glBindBuffer(GL_ARRAY_BUFFER, this->Buffer);
+  glBufferSubData(GL_ARRAY_BUFFER,
+                  0,
+                  this->Vertices.size() * sizeof(Vertex),
+                  this->Vertices.data());
+  glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(this->Vertices.size()));
+
+  glBindBuffer(GL_ARRAY_BUFFER, arrayBuffer);
+  glBindVertexArray(vertexArray);
+  glBindTexture(GL_TEXTURE_2D, texture);
+  glActiveTexture(activeTexture);
+  glUseProgram(program);
+}
@@ -0,0 +1,108 @@
+#ifndef vtkGlfwPerformanceHud_h
+#define vtkGlfwPerformanceHud_h
+
+#include "vtkType.h"
+
+#include <string>
+#include <vector>
+
+/**
+ * Performance overlay drawn straight into the back buffer.
+ *
+ * Text comes from a 5x7 bitmap font baked into a small texture once, and
+ * every frame the panel, text and frame time graph are written into one
+ * persistent vertex buffer and drawn with a single call, so the overlay
+ * costs microseconds. GPU time is measured with a ring of timer queries
+ * read back without stalling, a few frames late.
+ *
+ * All methods need the window's context current. The caller sets up the
+ * framebuffer, viewport and blending; Draw() restores the program, vertex
+ * array, buffer and texture bindings it changes.
+ */
+class vtkGlfwPerformanceHud
+{
+public:
+  struct Counters
+  {
+    double FrameTime = 0.0;
+    vtkIdType Frames = 0;
+    // -1 if unknown
+    vtkIdType Events = -1;
+    vtkIdType ContextSwitches = 0;
+  };
+
+  vtkGlfwPerformanceHud();
+  ~vtkGlfwPerformanceHud();
+
+  //@{
+  /**
+   * Bracket the GPU work of a frame with a timer query. Unmatched calls
+   * are ignored.
+   */
+  void BeginFrame();
+  void EndFrame();
+  //@}
+
+  /**
+   * Draw the overlay into the top left corner of a width x height pixel
+   * framebuffer, glyphs and graph scaled by scale.
+   */
+  void Draw(int width, int height, float scale, const Counters& counters);
+
+  /**
+   * Delete the OpenGL objects. They are created again by the next Draw().
+   */
+  void ReleaseGraphicsResources();
+
+private:
+  vtkGlfwPerformanceHud(const vtkGlfwPerformanceHud&) = delete;
+  void operator=(const vtkGlfwPerformanceHud&) = delete;
+
+  struct Vertex
+  {
+    float X, Y, U, V;
+    unsigned char Color[4];
+  };
+
+  bool CreateGraphicsResources();
+  void CollectQueries();
+  void UpdateText(const Counters& counters);
+  void AddQuad(float x0,
+               float y0,
+               float x1,
+               float y1,
+               const unsigned char color[4],
+               float u0 = -1.0f,
+               float v0 = -1.0f,
+               float u1 = -1.0f,
+               float v1 = -1.0f);
+  void AddText(float x, float y, float size, const std::string& text);
+
+  unsigned int Program;
+  unsigned int VertexArray;
+  unsigned int Buffer;
+  unsigned int Atlas;
+  int ViewportLocation;
+  int AtlasLocation;
+  std::vector<Vertex> Vertices;
+
+  // GPU timer queries, a ring of Pending results starting at Head
+  static const int NumberOfQueries = 4;
+  unsigned int Queries[NumberOfQueries];
+  int Head;
+  int Pending;
+  bool Active;
+  double GPUTime;
+
+  // frame times for the graph, a ring ending at GraphIndex
+  static const int GraphLength = 120;
+  float Graph[GraphLength];
+  int GraphIndex;
+
+  // rates are averaged over half a second, so the text stays readable
+  double SampleTime;
+  Counters Sampled;
+  std::vector<std::string> Lines;
+};
+
+#endif
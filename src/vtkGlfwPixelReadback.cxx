@@ -0,0 +1,180 @@
+#include "vtkGlfwPixelReadback.h"
+
+#include <algorithm>
+
+namespace {
+void
+readInto(GLuint& buffer,
+         size_t& capacity,
+         size_t size,
+         int width,
+         int height,
+         GLenum format,
+         GLenum type)
+{
+  if (!buffer) {
+    glGenBuffers(1, &buffer);
+  }
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer);
+  // grown, never shrunk, so a steady size allocates nothing
+  if (capacity < size) {
+    glBufferData(GL_PIXEL_PACK_BUFFER, size, nullptr, GL_STREAM_READ);
+    capacity = size;
+  }
+  glReadPixels(0, 0, width, height, format, type, nullptr);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+const void*
+mapBuffer(GLuint buffer, size_t size)
+{
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer);
+  const void* data =
+    glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+  return data;
+}
+
+void
+unmapBuffer(GLuint buffer)
+{
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer);
+  glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+}
+
+//------------------------------------------------------------------------------
+vtkGlfwPixelReadback::vtkGlfwPixelReadback(int numberOfBuffers)
+  : Entries(std::max(1, numberOfBuffers))
+  , First(0)
+  , Pending(0)
+{}
+
+//------------------------------------------------------------------------------
+bool
+vtkGlfwPixelReadback::Read(int width, int height, bool depth)
+{
+  const int count = static_cast<int>(this->Entries.size());
+  if (this->Pending == count || width <= 0 || height <= 0) {
+    return false;
+  }
+  Entry& entry = this->Entries[(this->First + this->Pending) % count];
+  const size_t pixels = size_t(width) * height;
+  readInto(entry.Color,
+           entry.ColorCapacity,
+           pixels * 4,
+           width,
+           height,
+           GL_RGBA,
+           GL_UNSIGNED_BYTE);
+  if (depth) {
+    readInto(entry.Depth,
+             entry.DepthCapacity,
+             pixels * sizeof(float),
+             width,
+             height,
+             GL_DEPTH_COMPONENT,
+             GL_FLOAT);
+  }
+  entry.Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  entry.Width = width;
+  entry.Height = height;
+  entry.HasDepth = depth;
+  ++this->Pending;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+bool
+vtkGlfwPixelReadback::IsOldestReady()
+{
+  if (!this->Pending) {
+    return false;
+  }
+  Entry& entry = this->Entries[this->First];
+  if (!entry.Fence) {
+    return true;
+  }
+  // flushes, so the fence is bound to signal without another swap
+  GLenum status = glClientWaitSync(entry.Fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+  if (status == GL_TIMEOUT_EXPIRED) {
+    return false;
+  }
+  glDeleteSync(entry.Fence);
+  entry.Fence = nullptr;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+bool
+vtkGlfwPixelReadback::MapOldest(Pixels& pixels)
+{
+  if (!this->Pending) {
+    return false;
+  }
+  Entry& entry = this->Entries[this->First];
+  if (!entry.MappedColor) {
+    // mapping waits for the copy by itself
+    if (entry.Fence) {
+      glDeleteSync(entry.Fence);
+      entry.Fence = nullptr;
+    }
+    const size_t size = size_t(entry.Width) * entry.Height;
+    entry.MappedColor = mapBuffer(entry.Color, size * 4);
+    if (entry.MappedColor && entry.HasDepth) {
+      entry.MappedDepth = mapBuffer(entry.Depth, size * sizeof(float));
+    }
+    if (!entry.MappedColor || (entry.HasDepth && !entry.MappedDepth)) {
+      return false;
+    }
+  }
+  pixels.Width = entry.Width;
+  pixels.Height = entry.Height;
+  pixels.Color = static_cast<const unsigned char*>(entry.MappedColor);
+  pixels.Depth = static_cast<const float*>(entry.MappedDepth);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwPixelReadback::PopOldest()
+{
+  if (!this->Pending) {
+    return;
+  }
+  Entry& entry = this->Entries[this->First];
+  if (entry.MappedColor) {
+    unmapBuffer(entry.Color);
+  }
+  if (entry.MappedDepth) {
+    unmapBuffer(entry.Depth);
+  }
+  if (entry.Fence) {
+    glDeleteSync(entry.Fence);
+  }
+  entry.Fence = nullptr;
+  entry.MappedColor = nullptr;
+  entry.MappedDepth = nullptr;
+  this->First = (this->First + 1) % static_cast<int>(this->Entries.size());
+  --this->Pending;
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwPixelReadback::ReleaseGraphicsResources()
+{
+  while (this->Pending) {
+    this->PopOldest();
+  }
+  for (Entry& entry : this->Entries) {
+    if (entry.Color) {
+      glDeleteBuffers(1, &entry.Color);
+    }
+    if (entry.Depth) {
+      glDeleteBuffers(1, &entry.Depth);
+    }
+    entry = Entry();
+  }
+  this->First = 0;
+}
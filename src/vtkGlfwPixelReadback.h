@@ -0,0 +1,97 @@
+#ifndef vtkGlfwPixelReadback_h
+#define vtkGlfwPixelReadback_h
+
+#include "vtk_glew.h"
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * Reads framebuffers back through a ring of pixel pack buffers.
+ *
+ * Read() only queues the copy on the GPU and returns. The pixels are mapped
+ * once a fence says they have arrived, typically a frame later, so the
+ * render thread never waits for the GPU to finish the frame it just
+ * submitted. Used by the tiled render and the frame readback of the
+ * window.
+ *
+ * All methods need the context the buffers were created in to be current,
+ * the destructor excepted: it frees nothing on the GPU, so call
+ * ReleaseGraphicsResources() while the context still exists.
+ */
+class vtkGlfwPixelReadback
+{
+public:
+  struct Pixels
+  {
+    int Width = 0;
+    int Height = 0;
+    // RGBA, bottom row first
+    const unsigned char* Color = nullptr;
+    // window depths, bottom row first, nullptr unless read
+    const float* Depth = nullptr;
+  };
+
+  /**
+   * Up to numberOfBuffers reads in flight, at least one.
+   */
+  explicit vtkGlfwPixelReadback(int numberOfBuffers);
+
+  /**
+   * Queue reading width x height RGBA pixels and, with depth, the window
+   * depths at the origin of the bound read framebuffer. The pack alignment
+   * is the caller's. Returns false if every buffer holds a read that was
+   * not popped yet.
+   */
+  bool Read(int width, int height, bool depth);
+
+  int GetNumberOfPendingReads() const { return this->Pending; }
+
+  /**
+   * Whether the GPU has finished the oldest pending read, i.e. mapping it
+   * will not wait.
+   */
+  bool IsOldestReady();
+
+  /**
+   * Map the oldest pending read, waiting for the GPU if needed. Returns
+   * false if there is none or it could not be mapped. The pointers stay
+   * valid until PopOldest().
+   */
+  bool MapOldest(Pixels& pixels);
+
+  /**
+   * Unmap and drop the oldest pending read.
+   */
+  void PopOldest();
+
+  /**
+   * Drop the pending reads and delete the buffers and fences.
+   */
+  void ReleaseGraphicsResources();
+
+private:
+  vtkGlfwPixelReadback(const vtkGlfwPixelReadback&) = delete;
+  void operator=(const vtkGlfwPixelReadback&) = delete;
+
+  struct Entry
+  {
+    GLuint Color = 0;
+    GLuint Depth = 0;
+    size_t ColorCapacity = 0;
+    size_t DepthCapacity = 0;
+    GLsync Fence = nullptr;
+    int Width = 0;
+    int Height = 0;
+    bool HasDepth = false;
+    const void* MappedColor = nullptr;
+    const void* MappedDepth = nullptr;
+  };
+
+  // a ring of Pending reads starting at First
+  std::vector<Entry> Entries;
+  int First;
+  int Pending;
+};
+
+#endif
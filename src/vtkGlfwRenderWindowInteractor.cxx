@@ -1,68 +1,147 @@
 #include "vtkCommand.h"
+#include "vtkGlfwOpenGLRenderWindow.h"
 #include "vtkGlfwRenderWindowInteractor.h"
+#include "vtkGlfwTrace.h"
 #include "vtkObjectFactory.h"
 #include "vtkRenderWindow.h"
 #include "vtkStringArray.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
 namespace vtkGlfwRenderWindowInteractor_detail {
+// The window owns the GLFW user pointer, we are its interactor. Events may
+// still arrive after the interactor was detached or replaced by another
+// kind, e.g. by vtkGlfwWindowPool::Release(); they are dropped.
+vtkGlfwRenderWindowInteractor*
+getInstance(GLFWwindow* wnd)
+{
+  auto win =
+    reinterpret_cast<vtkGlfwOpenGLRenderWindow*>(glfwGetWindowUserPointer(wnd));
+  if (!win) {
+    return nullptr;
+  }
+  return vtkGlfwRenderWindowInteractor::SafeDownCast(win->GetInteractor());
+}
 void
 charCallback(GLFWwindow* wnd, unsigned int codepoint)
 {
-  auto inst = reinterpret_cast<vtkGlfwRenderWindowInteractor*>(
-    glfwGetWindowUserPointer(wnd));
+  VTK_GLFW_TRACE_SCOPE("OnChar");
+  auto inst = getInstance(wnd);
+  if (!inst) {
+    return;
+  }
   inst->OnChar(wnd, codepoint);
 }
 void
 dropCallback(GLFWwindow* wnd, int count, const char** paths)
 {
-  auto inst = reinterpret_cast<vtkGlfwRenderWindowInteractor*>(
-    glfwGetWindowUserPointer(wnd));
+  VTK_GLFW_TRACE_SCOPE("OnDrop");
+  auto inst = getInstance(wnd);
+  if (!inst) {
+    return;
+  }
   inst->OnDrop(wnd, count, paths);
 }
 void
 enterCallback(GLFWwindow* wnd, int entered)
 {
-  auto inst = reinterpret_cast<vtkGlfwRenderWindowInteractor*>(
-    glfwGetWindowUserPointer(wnd));
+  VTK_GLFW_TRACE_SCOPE("OnEnter");
+  auto inst = getInstance(wnd);
+  if (!inst) {
+    return;
+  }
   inst->OnEnter(wnd, entered);
 }
 void
 cursorPosCallback(GLFWwindow* wnd, double x, double y)
 {
-  auto inst = reinterpret_cast<vtkGlfwRenderWindowInteractor*>(
-    glfwGetWindowUserPointer(wnd));
+  VTK_GLFW_TRACE_SCOPE("OnMouseMove");
+  auto inst = getInstance(wnd);
+  if (!inst) {
+    return;
+  }
   inst->OnMouseMove(wnd, x, y);
 }
 void
 mouseBtnCallback(GLFWwindow* wnd, int button, int action, int mods)
 {
-  auto inst = reinterpret_cast<vtkGlfwRenderWindowInteractor*>(
-    glfwGetWindowUserPointer(wnd));
+  VTK_GLFW_TRACE_SCOPE("OnMouseBtn");
+  auto inst = getInstance(wnd);
+  if (!inst) {
+    return;
+  }
   inst->OnMouseBtn(wnd, button, action, mods);
 }
 void
 mouseWhlCallback(GLFWwindow* wnd, double x, double y)
 {
-  auto inst = reinterpret_cast<vtkGlfwRenderWindowInteractor*>(
-    glfwGetWindowUserPointer(wnd));
+  VTK_GLFW_TRACE_SCOPE("OnMouseWhl");
+  auto inst = getInstance(wnd);
+  if (!inst) {
+    return;
+  }
   inst->OnMouseWhl(wnd, x, y);
 }
 void
 keyCallback(GLFWwindow* wnd, int key, int scancode, int action, int mods)
 {
-  auto inst = reinterpret_cast<vtkGlfwRenderWindowInteractor*>(
-    glfwGetWindowUserPointer(wnd));
+  VTK_GLFW_TRACE_SCOPE("OnKey");
+  auto inst = getInstance(wnd);
+  if (!inst) {
+    return;
+  }
   inst->OnKey(wnd, key, scancode, action, mods);
 }
-void
-wnSizeCallback(GLFWwindow* wnd, int w, int h)
-{
-  auto inst = reinterpret_cast<vtkGlfwRenderWindowInteractor*>(
-    glfwGetWindowUserPointer(wnd));
-  inst->OnSize(wnd, w, h);
-}
 }
 
+class vtkGlfwRenderWindowInteractor::vtkInternals
+{
+public:
+  std::mutex InjectedMutex;
+  std::vector<InjectedEvent> Injected;
+  std::vector<InjectedEvent> Dispatching;
+
+  // posted from any thread
+  std::mutex TaskMutex;
+  std::vector<Task> Tasks;
+  std::vector<Task> Running;
+  std::atomic<bool> RenderRequested{ false };
+
+  struct Timer
+  {
+    int Id;
+    double Interval;
+    bool Repeating;
+    double Due;
+  };
+  std::vector<Timer> Timers;
+  std::vector<int> DueTimers;
+  int NextTimerId = 1;
+
+  RefinementCallback Refine;
+  // input arrived since the event loop last went idle
+  bool InputSeen = false;
+  // set during a refinement abort check, input is queued instead
+  bool Deferring = false;
+  bool InputDuringAbortCheck = false;
+
+  // frame time governor
+  bool Interacting = false;
+  double InteractionEnd = 0.0;
+  int ButtonsDown = 0;
+
+  // raw mouse motion, in GLFW's orientation except Virtual, which is y up
+  double RawLast[2] = { 0.0, 0.0 };
+  double RawDelta[2] = { 0.0, 0.0 };
+  bool RawPending = false;
+  double Virtual[2] = { 0.0, 0.0 };
+};
+
 vtkStandardNewMacro(vtkGlfwRenderWindowInteractor);
 
 //------------------------------------------------------------------------------
@@ -70,10 +149,21 @@ vtkStandardNewMacro(vtkGlfwRenderWindowInteractor);
 vtkGlfwRenderWindowInteractor::vtkGlfwRenderWindowInteractor()
   : InstallCallbacks(true)
   , MouseInWindow(true)
+  , MaximumRefinementPasses(0)
+  , RefinementPass(0)
+  , RefinementConverged(false)
+  , InteractionEndDelay(0.25)
+  , NumberOfEvents(0)
+  , RawMouseMotion(false)
+  , PerformanceHudKey(GLFW_KEY_UNKNOWN)
+  , Internals(new vtkInternals)
 {}
 
 //------------------------------------------------------------------------------
-vtkGlfwRenderWindowInteractor::~vtkGlfwRenderWindowInteractor() {}
+vtkGlfwRenderWindowInteractor::~vtkGlfwRenderWindowInteractor()
+{
+  delete this->Internals;
+}
 
 //------------------------------------------------------------------------------
 void
@@ -83,7 +173,390 @@ vtkGlfwRenderWindowInteractor::ProcessEvents()
   if (!this->Enabled) {
     return;
   }
+  {
+    VTK_GLFW_TRACE_SCOPE("PollEvents");
+    glfwPollEvents();
+  }
+  this->DispatchPendingEvents();
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwRenderWindowInteractor::DispatchPendingEvents()
+{
+  VTK_GLFW_TRACE_SCOPE("DispatchPendingEvents");
+  this->DispatchRawMotion();
+  this->DispatchInjectedEvents();
+  this->RunPostedTasks();
+  this->FireTimers();
+  if (this->Internals->RenderRequested.exchange(false)) {
+    this->Render();
+  }
+  auto win = vtkGlfwOpenGLRenderWindow::SafeDownCast(this->RenderWindow);
+  if (win) {
+    win->RenderDeferred();
+    win->TrimResourcesIfDue();
+  }
+  this->EndInteractionIfIdle();
+  if (!this->Internals->InputSeen && this->IsRefinementPending()) {
+    this->RenderRefinementPass();
+  }
+  this->Internals->InputSeen = false;
+}
+
+//------------------------------------------------------------------------------
+double
+vtkGlfwRenderWindowInteractor::GetEventTimeout()
+{
+  double timeout = -1.0;
+  if (this->Internals->RenderRequested || this->GetNumberOfPendingTasks()) {
+    return 0.0;
+  }
+  auto win = vtkGlfwOpenGLRenderWindow::SafeDownCast(this->RenderWindow);
+  if (win) {
+    timeout = win->GetDeferredRenderDelay();
+    double wait = win->GetTrimResourcesDelay();
+    if (wait >= 0.0) {
+      timeout = timeout < 0.0 ? wait : std::min(timeout, wait);
+    }
+  }
+  const double now = glfwGetTime();
+  for (const auto& timer : this->Internals->Timers) {
+    double wait = std::max(0.0, timer.Due - now);
+    timeout = timeout < 0.0 ? wait : std::min(timeout, wait);
+  }
+  if (this->Internals->Interacting) {
+    double wait = std::max(0.0, this->Internals->InteractionEnd - now);
+    timeout = timeout < 0.0 ? wait : std::min(timeout, wait);
+  }
+  if (this->IsRefinementPending()) {
+    double wait = win ? win->GetThrottleDelay() : 0.0;
+    if (wait >= 0.0) {
+      timeout = timeout < 0.0 ? wait : std::min(timeout, wait);
+    }
+  }
+  return timeout;
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwRenderWindowInteractor::PostTask(Task task)
+{
+  if (!task) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(this->Internals->TaskMutex);
+    this->Internals->Tasks.push_back(std::move(task));
+  }
+  glfwPostEmptyEvent();
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwRenderWindowInteractor::RequestRender()
+{
+  if (!this->Internals->RenderRequested.exchange(true)) {
+    glfwPostEmptyEvent();
+  }
+}
+
+//------------------------------------------------------------------------------
+int
+vtkGlfwRenderWindowInteractor::GetNumberOfPendingTasks()
+{
+  std::lock_guard<std::mutex> lock(this->Internals->TaskMutex);
+  return static_cast<int>(this->Internals->Tasks.size());
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwRenderWindowInteractor::RunPostedTasks()
+{
+  // swapped out so posting never waits for a task to finish
+  auto& tasks = this->Internals->Running;
+  {
+    std::lock_guard<std::mutex> lock(this->Internals->TaskMutex);
+    if (this->Internals->Tasks.empty()) {
+      return;
+    }
+    tasks.swap(this->Internals->Tasks);
+  }
+  VTK_GLFW_TRACE_SCOPE("RunPostedTasks");
+  for (Task& task : tasks) {
+    task();
+  }
+  tasks.clear();
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwRenderWindowInteractor::SetRefinementCallback(
+  const RefinementCallback& callback)
+{
+  this->Internals->Refine = callback;
+}
+
+//------------------------------------------------------------------------------
+bool
+vtkGlfwRenderWindowInteractor::IsRefinementPending()
+{
+  return this->Enabled && !this->RefinementConverged &&
+         this->RefinementPass < this->MaximumRefinementPasses;
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwRenderWindowInteractor::NoteInput()
+{
+  auto internals = this->Internals;
+  if (internals->Deferring) {
+    internals->InputDuringAbortCheck = true;
+    return;
+  }
+  internals->InputSeen = true;
+  ++this->NumberOfEvents;
+  if (this->RefinementPass > 0 || this->RefinementConverged) {
+    this->RefinementPass = 0;
+    this->RefinementConverged = false;
+    if (internals->Refine) {
+      internals->Refine(0);
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+bool
+vtkGlfwRenderWindowInteractor::HandlePerformanceHudKey(int key, int action)
+{
+  if (key == GLFW_KEY_UNKNOWN || key != this->PerformanceHudKey ||
+      action != GLFW_PRESS) {
+    return false;
+  }
+  auto win = vtkGlfwOpenGLRenderWindow::SafeDownCast(this->RenderWindow);
+  if (!win) {
+    return false;
+  }
+  win->TogglePerformanceHud();
+  this->RequestRender();
+  return true;
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwRenderWindowInteractor::NoteInteraction()
+{
+  auto win = vtkGlfwOpenGLRenderWindow::SafeDownCast(this->RenderWindow);
+  if (!win || !win->GetFrameTimeGovernor()) {
+    return;
+  }
+  auto internals = this->Internals;
+  if (!internals->Interacting) {
+    internals->Interacting = true;
+    win->SetDesiredUpdateRate(this->DesiredUpdateRate);
+  }
+  internals->InteractionEnd = glfwGetTime() + this->InteractionEndDelay;
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwRenderWindowInteractor::EndInteractionIfIdle()
+{
+  auto internals = this->Internals;
+  if (!internals->Interacting || internals->ButtonsDown > 0 ||
+      glfwGetTime() < internals->InteractionEnd) {
+    return;
+  }
+  internals->Interacting = false;
+  vtkRenderWindow* ren = this->RenderWindow;
+  // styles that manage the rate themselves already rendered the still frame
+  if (ren && ren->GetDesiredUpdateRate() != this->StillUpdateRate) {
+    ren->SetDesiredUpdateRate(this->StillUpdateRate);
+    this->Render();
+  }
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwRenderWindowInteractor::RenderRefinementPass()
+{
+  vtkRenderWindow* ren = this->RenderWindow;
+  auto win = vtkGlfwOpenGLRenderWindow::SafeDownCast(ren);
+  if (!ren || (win && win->GetThrottleDelay() != 0.0)) {
+    return;
+  }
+
+  const int pass = this->RefinementPass + 1;
+  auto& refine = this->Internals->Refine;
+  if (refine && !refine(pass)) {
+    this->RefinementConverged = true;
+    return;
+  }
+  // counted even if aborted, the input that aborts it restarts refinement
+  this->RefinementPass = pass;
+  VTK_GLFW_TRACE_SCOPE("RefinementPass");
+
+  unsigned long observer =
+    ren->AddObserver(vtkCommand::AbortCheckEvent,
+                     this,
+                     &vtkGlfwRenderWindowInteractor::OnAbortCheck);
+  ren->SetAbortRender(0);
+  ren->Render();
+  ren->RemoveObserver(observer);
+  if (ren->GetAbortRender()) {
+    vtkDebugMacro(<< "Refinement pass " << pass << " aborted by input");
+  }
+  ren->SetAbortRender(0);
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwRenderWindowInteractor::OnAbortCheck(vtkObject*, unsigned long, void*)
+{
+  auto internals = this->Internals;
+  if (internals->Deferring) {
+    return;
+  }
+
+  // the handlers queue input through InjectEvent() while Deferring is set,
+  // so it is dispatched after the render instead of in the middle of it
+  VTK_GLFW_TRACE_SCOPE("AbortCheck");
+  internals->Deferring = true;
+  internals->InputDuringAbortCheck = false;
   glfwPollEvents();
+  internals->Deferring = false;
+
+  bool queued;
+  {
+    std::lock_guard<std::mutex> lock(internals->InjectedMutex);
+    queued = !internals->Injected.empty();
+  }
+  if (queued || internals->InputDuringAbortCheck) {
+    this->RenderWindow->SetAbortRender(1);
+  }
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwRenderWindowInteractor::FireTimers()
+{
+  auto& timers = this->Internals->Timers;
+  if (timers.empty()) {
+    return;
+  }
+
+  // collect first, observers may create and destroy timers
+  auto& due = this->Internals->DueTimers;
+  const double now = glfwGetTime();
+  for (auto& timer : timers) {
+    if (timer.Due <= now) {
+      due.push_back(timer.Id);
+      if (timer.Repeating) {
+        // skip missed periods rather than firing a burst to catch up
+        timer.Due = std::max(timer.Due + timer.Interval, now);
+      }
+    }
+  }
+
+  for (int platformTimerId : due) {
+    int timerId = this->GetVTKTimerId(platformTimerId);
+    if (!timerId) {
+      continue;
+    }
+    bool oneShot = this->IsOneShotTimer(timerId) != 0;
+    {
+      VTK_GLFW_TRACE_SCOPE("TimerEvent");
+      this->InvokeEvent(vtkCommand::TimerEvent, &timerId);
+    }
+    if (oneShot) {
+      this->DestroyTimer(timerId);
+    }
+  }
+  due.clear();
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwRenderWindowInteractor::InjectEvent(const InjectedEvent& event)
+{
+  {
+    std::lock_guard<std::mutex> lock(this->Internals->InjectedMutex);
+    this->Internals->Injected.push_back(event);
+  }
+  glfwPostEmptyEvent();
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwRenderWindowInteractor::DispatchInjectedEvents()
+{
+  auto& events = this->Internals->Dispatching;
+  {
+    std::lock_guard<std::mutex> lock(this->Internals->InjectedMutex);
+    if (this->Internals->Injected.empty()) {
+      return;
+    }
+    events.swap(this->Internals->Injected);
+  }
+  VTK_GLFW_TRACE_SCOPE("DispatchInjectedEvents");
+
+  for (const auto& event : events) {
+    if (!this->Enabled) {
+      break;
+    }
+    this->NoteInput();
+    int alt = event.Mods & GLFW_MOD_ALT;
+    int ctrl = event.Mods & GLFW_MOD_CONTROL;
+    int shift = event.Mods & GLFW_MOD_SHIFT;
+    this->SetAltKey(alt);
+    switch (event.Type) {
+      case InjectedEvent::MOUSE_MOVE:
+        if (this->Internals->ButtonsDown > 0) {
+          this->NoteInteraction();
+        }
+        this->SetEventInformationFlipY(event.X, event.Y, ctrl, shift);
+        this->InvokeEvent(vtkCommand::MouseMoveEvent, nullptr);
+        break;
+      case InjectedEvent::MOUSE_BUTTON:
+        this->DispatchMouseButton(
+          event.X, event.Y, event.Button, event.Action, event.Mods);
+        break;
+      case InjectedEvent::SCROLL:
+        this->NoteInteraction();
+        this->SetEventInformationFlipY(event.X, event.Y, ctrl, shift);
+        this->InvokeEvent(event.Delta > 0
+                            ? vtkCommand::MouseWheelForwardEvent
+                            : vtkCommand::MouseWheelBackwardEvent,
+                          nullptr);
+        break;
+      case InjectedEvent::KEY:
+        if (this->HandlePerformanceHudKey(event.Key, event.Action)) {
+          break;
+        }
+        if (event.Action != GLFW_RELEASE) {
+          this->NoteInteraction();
+        }
+        // remote viewers know no scancodes
+        this->SetKeyEventInformation(ctrl,
+                                     shift,
+                                     event.Scancode ? event.Scancode
+                                                    : event.Key,
+                                     event.Action == GLFW_REPEAT,
+                                     event.KeySym[0] ? event.KeySym : nullptr);
+        this->InvokeEvent(event.Action == GLFW_RELEASE
+                            ? vtkCommand::KeyReleaseEvent
+                            : vtkCommand::KeyPressEvent,
+                          nullptr);
+        break;
+      case InjectedEvent::CHAR:
+        this->SetKeyEventInformation(ctrl, shift, event.Codepoint);
+        this->InvokeEvent(vtkCommand::CharEvent, nullptr);
+        break;
+      default:
+        break;
+    }
+  }
+  events.clear();
 }
 
 //------------------------------------------------------------------------------
@@ -100,12 +573,39 @@ vtkGlfwRenderWindowInteractor::StartEventLoop()
     vtkErrorMacro(<< "No renderer defined!");
     return;
   }
+  while (this->WaitAndProcessEvents()) {
+  }
+}
+
+//------------------------------------------------------------------------------
+bool
+vtkGlfwRenderWindowInteractor::WaitAndProcessEvents(double timeout)
+{
   vtkRenderWindow* ren = this->RenderWindow;
+  if (!this->Enabled || !ren) {
+    return false;
+  }
   GLFWwindow* wnd = static_cast<GLFWwindow*>(ren->GetGenericWindowId());
+  if (this->Done || glfwWindowShouldClose(wnd)) {
+    return false;
+  }
 
-  while (!(this->Done || glfwWindowShouldClose(wnd))) {
-    this->ProcessEvents();
+  double wait = this->GetEventTimeout();
+  if (timeout >= 0.0) {
+    wait = wait < 0.0 ? timeout : std::min(wait, timeout);
   }
+  {
+    VTK_GLFW_TRACE_SCOPE("WaitEvents");
+    if (wait < 0.0) {
+      glfwWaitEvents();
+    } else if (wait > 0.0) {
+      glfwWaitEventsTimeout(wait);
+    } else {
+      glfwPollEvents();
+    }
+  }
+  this->DispatchPendingEvents();
+  return this->Enabled && !(this->Done || glfwWindowShouldClose(wnd));
 }
 
 //------------------------------------------------------------------------------
@@ -126,8 +626,6 @@ vtkGlfwRenderWindowInteractor::Initialize()
   this->Initialized = 1;
   // get the info we need from the RenderingWindow
   vtkRenderWindow* ren = this->RenderWindow;
-  GLFWwindow* wnd = static_cast<GLFWwindow*>(ren->GetGenericWindowId());
-  glfwSetWindowUserPointer(wnd, this);
   ren->Start();
   ren->End();
   size = ren->GetSize();
@@ -163,9 +661,11 @@ vtkGlfwRenderWindowInteractor::Enable()
     glfwSetMouseButtonCallback(wnd, mouseBtnCallback);
     glfwSetScrollCallback(wnd, mouseWhlCallback);
     glfwSetKeyCallback(wnd, keyCallback);
-    glfwSetWindowSizeCallback(wnd, wnSizeCallback);
   }
   this->Enabled = 1;
+  if (this->RawMouseMotion) {
+    this->ApplyCursorMode(true);
+  }
   this->Modified();
 }
 
@@ -194,12 +694,90 @@ vtkGlfwRenderWindowInteractor::Disable()
     glfwSetMouseButtonCallback(wnd, NULL);
     glfwSetScrollCallback(wnd, NULL);
     glfwSetKeyCallback(wnd, NULL);
-    glfwSetWindowSizeCallback(wnd, NULL);
+  }
+  if (this->RawMouseMotion) {
+    this->ApplyCursorMode(false);
   }
   this->Enabled = 0;
   this->Modified();
 }
 
+//------------------------------------------------------------------------------
+void
+vtkGlfwRenderWindowInteractor::SetRawMouseMotion(bool raw)
+{
+  if (this->RawMouseMotion == raw) {
+    return;
+  }
+  this->RawMouseMotion = raw;
+  if (this->Enabled) {
+    this->ApplyCursorMode(raw);
+  }
+  this->Modified();
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwRenderWindowInteractor::ApplyCursorMode(bool raw)
+{
+  vtkRenderWindow* ren = this->RenderWindow;
+  auto wnd = ren ? static_cast<GLFWwindow*>(ren->GetGenericWindowId())
+                 : nullptr;
+  if (!wnd) {
+    return;
+  }
+
+  auto internals = this->Internals;
+  if (raw) {
+    glfwSetInputMode(wnd, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+    if (glfwRawMouseMotionSupported()) {
+      glfwSetInputMode(wnd, GLFW_RAW_MOUSE_MOTION, GLFW_TRUE);
+    }
+    glfwGetCursorPos(wnd, internals->RawLast, internals->RawLast + 1);
+    // carry on from where the pointer was
+    internals->Virtual[0] = this->EventPosition[0];
+    internals->Virtual[1] = this->EventPosition[1];
+    internals->RawDelta[0] = internals->RawDelta[1] = 0.0;
+    internals->RawPending = false;
+  } else {
+    if (glfwRawMouseMotionSupported()) {
+      glfwSetInputMode(wnd, GLFW_RAW_MOUSE_MOTION, GLFW_FALSE);
+    }
+    glfwSetInputMode(wnd, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
+  }
+}
+
+//------------------------------------------------------------------------------
+int
+vtkGlfwRenderWindowInteractor::DispatchRawMotion()
+{
+  auto internals = this->Internals;
+  if (!internals->RawPending || !this->Enabled) {
+    return 0;
+  }
+  internals->RawPending = false;
+  double delta[2] = { internals->RawDelta[0], -internals->RawDelta[1] };
+  internals->RawDelta[0] = internals->RawDelta[1] = 0.0;
+  internals->Virtual[0] += delta[0];
+  internals->Virtual[1] += delta[1];
+  if (internals->ButtonsDown > 0) {
+    this->NoteInteraction();
+  }
+
+  auto wnd = static_cast<GLFWwindow*>(this->RenderWindow->GetGenericWindowId());
+  auto down = [wnd](int left, int right) {
+    return glfwGetKey(wnd, left) == GLFW_PRESS ||
+           glfwGetKey(wnd, right) == GLFW_PRESS;
+  };
+  this->SetAltKey(down(GLFW_KEY_LEFT_ALT, GLFW_KEY_RIGHT_ALT));
+  this->SetEventInformation(
+    static_cast<int>(std::lround(internals->Virtual[0])),
+    static_cast<int>(std::lround(internals->Virtual[1])),
+    down(GLFW_KEY_LEFT_CONTROL, GLFW_KEY_RIGHT_CONTROL),
+    down(GLFW_KEY_LEFT_SHIFT, GLFW_KEY_RIGHT_SHIFT));
+  return this->InvokeEvent(vtkCommand::MouseMoveEvent, delta);
+}
+
 //------------------------------------------------------------------------------
 void
 vtkGlfwRenderWindowInteractor::TerminateApp(void)
@@ -209,24 +787,74 @@ vtkGlfwRenderWindowInteractor::TerminateApp(void)
 
 //------------------------------------------------------------------------------
 int
-vtkGlfwRenderWindowInteractor::InternalCreateTimer(int timerId,
-                                                   int vtkNotUsed(timerType),
+vtkGlfwRenderWindowInteractor::InternalCreateTimer(int vtkNotUsed(timerId),
+                                                   int timerType,
                                                    unsigned long duration)
 {
-  return 1;
+  vtkInternals::Timer timer;
+  timer.Id = this->Internals->NextTimerId++;
+  timer.Interval = duration / 1000.0;
+  timer.Repeating = timerType == RepeatingTimer;
+  timer.Due = glfwGetTime() + timer.Interval;
+  this->Internals->Timers.push_back(timer);
+  return timer.Id;
 }
 
 //------------------------------------------------------------------------------
 int
 vtkGlfwRenderWindowInteractor::InternalDestroyTimer(int platformTimerId)
 {
+  auto& timers = this->Internals->Timers;
+  auto it = std::find_if(timers.begin(),
+                         timers.end(),
+                         [platformTimerId](const vtkInternals::Timer& t) {
+                           return t.Id == platformTimerId;
+                         });
+  if (it == timers.end()) {
+    return 0;
+  }
+  timers.erase(it);
   return 1;
 }
 
 //------------------------------------------------------------------------------
 void
 vtkGlfwRenderWindowInteractor::PrintSelf(ostream& os, vtkIndent indent)
-{}
+{
+  this->Superclass::PrintSelf(os, indent);
+
+  os << indent << "InstallCallbacks: " << this->InstallCallbacks << "\n";
+  os << indent << "MouseInWindow: " << this->MouseInWindow << "\n";
+  os << indent << "PerformanceHudKey: " << this->PerformanceHudKey << "\n";
+  os << indent << "MaximumRefinementPasses: " << this->MaximumRefinementPasses
+     << "\n";
+  os << indent << "RefinementPass: " << this->RefinementPass << "\n";
+  os << indent << "RefinementConverged: " << this->RefinementConverged
+     << "\n";
+  os << indent << "InteractionEndDelay: " << this->InteractionEndDelay
+     << "\n";
+  os << indent << "NumberOfEvents: " << this->NumberOfEvents << "\n";
+  os << indent << "RawMouseMotion: " << this->RawMouseMotion << "\n";
+
+  auto internals = this->Internals;
+  size_t injected, tasks;
+  {
+    std::lock_guard<std::mutex> lock(internals->InjectedMutex);
+    injected = internals->Injected.size();
+  }
+  {
+    std::lock_guard<std::mutex> lock(internals->TaskMutex);
+    tasks = internals->Tasks.size();
+  }
+  os << indent << "PendingInjectedEvents: " << injected << "\n";
+  os << indent << "PendingTasks: " << tasks << "\n";
+  os << indent << "RenderRequested: " << internals->RenderRequested.load()
+     << "\n";
+  os << indent << "Timers: " << internals->Timers.size() << "\n";
+  os << indent << "Deferring: " << internals->Deferring << "\n";
+  os << indent << "Interacting: " << internals->Interacting << "\n";
+  os << indent << "ButtonsDown: " << internals->ButtonsDown << "\n";
+}
 
 //------------------------------------------------------------------------------
 void
@@ -245,6 +873,15 @@ vtkGlfwRenderWindowInteractor::OnChar(GLFWwindow* wnd, unsigned int codepoint)
   if (!this->Enabled)
     return 0;
 
+  if (this->Internals->Deferring) {
+    InjectedEvent event;
+    event.Type = InjectedEvent::CHAR;
+    event.Codepoint = codepoint;
+    this->InjectEvent(event);
+    return 0;
+  }
+  this->NoteInput();
+
   int alt = glfwGetKey(wnd, GLFW_MOD_ALT);
   int ctrl = glfwGetKey(wnd, GLFW_MOD_CONTROL);
   int shift = glfwGetKey(wnd, GLFW_MOD_SHIFT);
@@ -262,6 +899,7 @@ vtkGlfwRenderWindowInteractor::OnDrop(GLFWwindow* wnd,
   if (!this->Enabled)
     return 0;
 
+  this->NoteInput();
   double location[2] = {};
   glfwGetCursorPos(wnd, location, location + 1);
   this->InvokeEvent(vtkCommand::UpdateDropLocationEvent, location);
@@ -283,6 +921,7 @@ vtkGlfwRenderWindowInteractor::OnEnter(GLFWwindow* wnd, int entered)
   if (!this->Enabled)
     return 0;
 
+  this->NoteInput();
   this->MouseInWindow = entered;
   if (entered)
     return this->InvokeEvent(vtkCommand::EnterEvent, nullptr);
@@ -295,10 +934,34 @@ vtkGlfwRenderWindowInteractor::OnMouseMove(GLFWwindow* wnd, double x, double y)
 {
   if (!this->Enabled)
     return 0;
-;
+
+  if (this->RawMouseMotion) {
+    // coalesced until DispatchRawMotion()
+    auto internals = this->Internals;
+    internals->RawDelta[0] += x - internals->RawLast[0];
+    internals->RawDelta[1] += y - internals->RawLast[1];
+    internals->RawLast[0] = x;
+    internals->RawLast[1] = y;
+    internals->RawPending = true;
+    this->NoteInput();
+    return 0;
+  }
   if (!this->MouseInWindow)
     return 0;
 
+  if (this->Internals->Deferring) {
+    InjectedEvent event;
+    event.Type = InjectedEvent::MOUSE_MOVE;
+    event.X = x;
+    event.Y = y;
+    this->InjectEvent(event);
+    return 0;
+  }
+  this->NoteInput();
+  if (this->Internals->ButtonsDown > 0) {
+    this->NoteInteraction();
+  }
+
   int alt = glfwGetKey(wnd, GLFW_MOD_ALT);
   int ctrl = glfwGetKey(wnd, GLFW_MOD_CONTROL);
   int shift = glfwGetKey(wnd, GLFW_MOD_SHIFT);
@@ -316,14 +979,54 @@ vtkGlfwRenderWindowInteractor::OnMouseBtn(GLFWwindow* wnd,
   if (!this->Enabled)
     return 0;
 
+  double x(0), y(0);
+  glfwGetCursorPos(wnd, &x, &y);
+  if (this->Internals->Deferring) {
+    InjectedEvent event;
+    event.Type = InjectedEvent::MOUSE_BUTTON;
+    event.X = x;
+    event.Y = y;
+    event.Button = button;
+    event.Action = action;
+    event.Mods = mods;
+    this->InjectEvent(event);
+    return 0;
+  }
+  this->NoteInput();
+  return this->DispatchMouseButton(x, y, button, action, mods);
+}
+
+int
+vtkGlfwRenderWindowInteractor::DispatchMouseButton(double x,
+                                                   double y,
+                                                   int button,
+                                                   int action,
+                                                   int mods)
+{
+  auto internals = this->Internals;
+  if (action == GLFW_PRESS) {
+    ++internals->ButtonsDown;
+    this->NoteInteraction();
+  } else if (action == GLFW_RELEASE && internals->ButtonsDown > 0) {
+    --internals->ButtonsDown;
+  }
+
   int alt = mods & GLFW_MOD_ALT;
   int ctrl = mods & GLFW_MOD_CONTROL;
   int shift = mods & GLFW_MOD_SHIFT;
-  this->SetAltKey(alt);
-
-  double x(0), y(0);
-  glfwGetCursorPos(wnd, &x, &y);
-  this->SetEventInformationFlipY(x, y, ctrl, shift);
+  if (this->RawMouseMotion) {
+    // motion first, then the press at the position it moved to
+    this->DispatchRawMotion();
+    this->SetAltKey(alt);
+    this->SetEventInformation(
+      static_cast<int>(std::lround(internals->Virtual[0])),
+      static_cast<int>(std::lround(internals->Virtual[1])),
+      ctrl,
+      shift);
+  } else {
+    this->SetAltKey(alt);
+    this->SetEventInformationFlipY(x, y, ctrl, shift);
+  }
 
   int retval(0);
   switch (action) {
@@ -331,12 +1034,15 @@ vtkGlfwRenderWindowInteractor::OnMouseBtn(GLFWwindow* wnd,
       switch (button) {
         case GLFW_MOUSE_BUTTON_LEFT:
           retval = this->InvokeEvent(vtkCommand::LeftButtonPressEvent, nullptr);
+          break;
         case GLFW_MOUSE_BUTTON_MIDDLE:
           retval =
             this->InvokeEvent(vtkCommand::MiddleButtonPressEvent, nullptr);
+          break;
         case GLFW_MOUSE_BUTTON_RIGHT:
           retval =
             this->InvokeEvent(vtkCommand::RightButtonPressEvent, nullptr);
+          break;
         default:
           break;
       }
@@ -346,12 +1052,15 @@ vtkGlfwRenderWindowInteractor::OnMouseBtn(GLFWwindow* wnd,
         case GLFW_MOUSE_BUTTON_LEFT:
           retval =
             this->InvokeEvent(vtkCommand::LeftButtonReleaseEvent, nullptr);
+          break;
         case GLFW_MOUSE_BUTTON_MIDDLE:
           retval =
             this->InvokeEvent(vtkCommand::MiddleButtonReleaseEvent, nullptr);
+          break;
         case GLFW_MOUSE_BUTTON_RIGHT:
           retval =
             this->InvokeEvent(vtkCommand::RightButtonReleaseEvent, nullptr);
+          break;
         default:
           break;
       }
@@ -369,6 +1078,17 @@ vtkGlfwRenderWindowInteractor::OnMouseWhl(GLFWwindow* wnd, double x, double y)
   if (!this->Enabled)
     return 0;
 
+  if (this->Internals->Deferring) {
+    InjectedEvent event;
+    event.Type = InjectedEvent::SCROLL;
+    glfwGetCursorPos(wnd, &event.X, &event.Y);
+    event.Delta = y;
+    this->InjectEvent(event);
+    return 0;
+  }
+  this->NoteInput();
+  this->NoteInteraction();
+
   int alt = glfwGetKey(wnd, GLFW_MOD_ALT);
   int ctrl = glfwGetKey(wnd, GLFW_MOD_CONTROL);
   int shift = glfwGetKey(wnd, GLFW_MOD_SHIFT);
@@ -392,11 +1112,32 @@ vtkGlfwRenderWindowInteractor::OnKey(GLFWwindow* wnd,
   if (!this->Enabled)
     return 0;
 
+  const char* keysym = glfwGetKeyName(key, scancode);
+  if (this->Internals->Deferring) {
+    InjectedEvent event;
+    event.Type = InjectedEvent::KEY;
+    event.Key = key;
+    event.Scancode = scancode;
+    event.Action = action;
+    event.Mods = mods;
+    if (keysym) {
+      std::strncpy(event.KeySym, keysym, sizeof(event.KeySym) - 1);
+    }
+    this->InjectEvent(event);
+    return 0;
+  }
+  this->NoteInput();
+  if (this->HandlePerformanceHudKey(key, action)) {
+    return 1;
+  }
+  if (action != GLFW_RELEASE) {
+    this->NoteInteraction();
+  }
+
   int alt = mods & GLFW_MOD_ALT;
   int ctrl = mods & GLFW_MOD_CONTROL;
   int shift = mods & GLFW_MOD_SHIFT;
 
-  const char* keysym = glfwGetKeyName(key, scancode);
   int repeat = (action == GLFW_REPEAT);
   this->SetKeyEventInformation(ctrl, shift, scancode, repeat, keysym);
 
@@ -412,6 +1153,7 @@ vtkGlfwRenderWindowInteractor::OnSize(GLFWwindow* wnd, int w, int h)
   if (!this->Enabled)
     return 0;
 
+  this->NoteInput();
   this->UpdateSize(w, h);
 
   if (this->Enabled)
@@ -0,0 +1,701 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "vtkObjectFactory.h"
+#include "vtkShaderProgram.h"
+#include "vtk_glew.h"
+
+#include <vtksys/Directory.hxx>
+#include <vtksys/SystemTools.hxx>
+
+// clang-format off
+#include "vtkGlfwShaderBinaryCache.h"
+#include "vtkGlfwTrace.h"
+#include "vtkGlfwUploadContext.h"
+// clang-format on
+
+namespace {
+// vtkShaderProgram lets only vtkOpenGLShaderCache set its program object.
+// Pointers to its protected members, formed in a subclass, work on any
+// vtkShaderProgram; this class is never instantiated.
+class ProgramAccess : public vtkShaderProgram
+{
+public:
+  static void Adopt(vtkShaderProgram* shader, int handle)
+  {
+    shader->*(&ProgramAccess::Handle) = handle;
+    shader->*(&ProgramAccess::Linked) = true;
+  }
+};
+
+const uint32_t Magic = 0x42534756; // "VGSB"
+const uint32_t Version = 1;
+const char* const BinaryExtension = ".bin";
+// device, vertex, fragment and geometry source, separated by '\0'
+const char* const SourceExtension = ".glsl";
+
+struct BinaryHeader
+{
+  uint32_t Magic;
+  uint32_t Version;
+  uint32_t Format;
+  uint32_t Size;
+};
+
+// FNV-1a, stable across compilers and runs unlike std::hash
+uint64_t
+hashString(const std::string& text, uint64_t hash = 14695981039346656037ull)
+{
+  for (unsigned char c : text) {
+    hash = (hash ^ c) * 1099511628211ull;
+  }
+  return hash;
+}
+
+std::string
+shaderSource(vtkShader* shader)
+{
+  return shader ? shader->GetSource() : std::string();
+}
+
+bool
+endsWith(const std::string& text, const char* suffix)
+{
+  const size_t n = strlen(suffix);
+  return text.size() >= n && text.compare(text.size() - n, n, suffix) == 0;
+}
+
+bool
+readFile(const std::string& path, std::vector<char>& data)
+{
+  FILE* file = fopen(path.c_str(), "rb");
+  if (!file) {
+    return false;
+  }
+  data.clear();
+  char chunk[4096];
+  size_t n;
+  while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+    data.insert(data.end(), chunk, chunk + n);
+  }
+  bool ok = !ferror(file);
+  fclose(file);
+  return ok;
+}
+
+// readers in other processes only ever see complete files
+bool
+writeFile(const std::string& path, const std::vector<std::string>& parts)
+{
+  const std::string temporary =
+    path + "." +
+    std::to_string(
+      std::chrono::steady_clock::now().time_since_epoch().count()) +
+    ".tmp";
+  FILE* file = fopen(temporary.c_str(), "wb");
+  if (!file) {
+    return false;
+  }
+  bool ok = true;
+  for (const std::string& part : parts) {
+    ok = ok && fwrite(part.data(), 1, part.size(), file) == part.size();
+  }
+  ok = fclose(file) == 0 && ok;
+  if (!ok || !vtksys::SystemTools::RenameFile(temporary, path)) {
+    vtksys::SystemTools::RemoveFile(temporary);
+    return false;
+  }
+  return true;
+}
+
+// a linked program, 0 if the file is missing, damaged or rejected
+GLuint
+programFromBinary(const std::string& path)
+{
+  std::vector<char> data;
+  if (!readFile(path, data) || data.size() <= sizeof(BinaryHeader)) {
+    return 0;
+  }
+  BinaryHeader header;
+  memcpy(&header, data.data(), sizeof(header));
+  if (header.Magic != Magic || header.Version != Version ||
+      header.Size != data.size() - sizeof(header)) {
+    return 0;
+  }
+  GLuint program = glCreateProgram();
+  // so StoreBinary() may read it back
+  glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+  glProgramBinary(program,
+                  header.Format,
+                  data.data() + sizeof(header),
+                  static_cast<GLsizei>(header.Size));
+  GLint linked = 0;
+  glGetProgramiv(program, GL_LINK_STATUS, &linked);
+  if (!linked) {
+    glDeleteProgram(program);
+    return 0;
+  }
+  return program;
+}
+
+GLuint
+compileShader(GLenum type, const std::string& source)
+{
+  GLuint shader = glCreateShader(type);
+  const char* text = source.c_str();
+  glShaderSource(shader, 1, &text, nullptr);
+  glCompileShader(shader);
+  GLint compiled = 0;
+  glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+  if (!compiled) {
+    glDeleteShader(shader);
+    return 0;
+  }
+  return shader;
+}
+
+// links the way vtkShaderProgram::CompileShader() does, but asks the
+// driver to keep the binary retrievable
+GLuint
+programFromSources(const std::string& vertex,
+                   const std::string& fragment,
+                   const std::string& geometry)
+{
+  GLuint program = glCreateProgram();
+  std::vector<GLuint> shaders;
+  bool ok = true;
+  const std::pair<GLenum, const std::string*> stages[] = {
+    { GL_VERTEX_SHADER, &vertex },
+    { GL_FRAGMENT_SHADER, &fragment },
+    { GL_GEOMETRY_SHADER, &geometry },
+  };
+  for (const auto& stage : stages) {
+    if (stage.second->empty()) {
+      continue;
+    }
+    GLuint shader = compileShader(stage.first, *stage.second);
+    if (!shader) {
+      ok = false;
+      break;
+    }
+    glAttachShader(program, shader);
+    shaders.push_back(shader);
+  }
+
+  GLint linked = 0;
+  if (ok) {
+#ifndef GL_ES_VERSION_3_0
+    for (int i = 1;; ++i) {
+      std::string output = "fragOutput" + std::to_string(i);
+      if (fragment.find(output) == std::string::npos) {
+        break;
+      }
+      glBindFragDataLocation(program, i, output.c_str());
+    }
+#endif
+    glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    glLinkProgram(program);
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+  }
+  for (GLuint shader : shaders) {
+    glDetachShader(program, shader);
+    glDeleteShader(shader);
+  }
+  if (!linked) {
+    glDeleteProgram(program);
+    return 0;
+  }
+  return program;
+}
+
+// runs on the upload context's worker
+GLuint
+warmUpProgram(const std::string& binaryPath,
+              const std::string& sourcePath,
+              const std::string& device)
+{
+  VTK_GLFW_TRACE_SCOPE("WarmUpProgram");
+  GLuint program = programFromBinary(binaryPath);
+  if (program) {
+    return program;
+  }
+  std::vector<char> data;
+  if (!readFile(sourcePath, data)) {
+    return 0;
+  }
+  std::vector<std::string> parts;
+  auto begin = data.begin();
+  for (auto it = data.begin(); it != data.end(); ++it) {
+    if (*it == '\0') {
+      parts.emplace_back(begin, it);
+      begin = it + 1;
+    }
+  }
+  parts.emplace_back(begin, data.end());
+  if (parts.size() != 4 || parts[0] != device) {
+    return 0;
+  }
+  return programFromSources(parts[1], parts[2], parts[3]);
+}
+}
+
+class vtkGlfwShaderBinaryCache::vtkInternals
+{
+public:
+  // -1 until the context was asked
+  int Available = -1;
+  std::string Device;
+  // bytes in the directory, -1 until it was scanned
+  vtkIdType CurrentSize = -1;
+
+  // programs WarmUp() queued, by key, and those asked for too early
+  vtkGlfwUploadContext* WarmUpContext = nullptr;
+  std::map<uint64_t, vtkIdType> WarmUp;
+  std::vector<vtkIdType> Orphans;
+};
+
+vtkStandardNewMacro(vtkGlfwShaderBinaryCache);
+
+//------------------------------------------------------------------------------
+vtkGlfwShaderBinaryCache::vtkGlfwShaderBinaryCache()
+  : Directory(nullptr)
+  , MaximumSize(64 << 20)
+  , NumberOfHits(0)
+  , NumberOfWarmUpHits(0)
+  , NumberOfMisses(0)
+  , NumberOfRejected(0)
+  , NumberOfWrites(0)
+  , NumberOfEvictions(0)
+  , Internals(new vtkInternals)
+{
+  const char* directory = getenv("VTKGLFW_SHADER_CACHE");
+  if (directory && *directory) {
+    this->SetDirectory(directory);
+  }
+}
+
+//------------------------------------------------------------------------------
+vtkGlfwShaderBinaryCache::~vtkGlfwShaderBinaryCache()
+{
+  this->SetDirectory(nullptr);
+  delete this->Internals;
+}
+
+//------------------------------------------------------------------------------
+vtkShaderProgram*
+vtkGlfwShaderBinaryCache::ReadyShaderProgram(vtkShaderProgram* shader,
+                                             vtkTransformFeedback* cap)
+{
+  if (!shader || shader->GetCompiled() || cap ||
+      shader->GetTransformFeedback() || !this->IsAvailable()) {
+    return this->Superclass::ReadyShaderProgram(shader, cap);
+  }
+  this->DeleteOrphans();
+
+  const uint64_t key = this->GetProgramKey(shader);
+  if (this->AdoptWarmProgram(shader, key)) {
+    ++this->NumberOfWarmUpHits;
+    if (!vtksys::SystemTools::FileExists(
+          this->GetFilePath(key, BinaryExtension))) {
+      this->StoreBinary(shader, key);
+    }
+    return this->Superclass::ReadyShaderProgram(shader, cap);
+  }
+  if (this->LoadBinary(shader, key)) {
+    ++this->NumberOfHits;
+    // only binds now
+    return this->Superclass::ReadyShaderProgram(shader, cap);
+  }
+  ++this->NumberOfMisses;
+  // VTK would link without the retrievable hint, so link here
+  GLuint handle;
+  {
+    VTK_GLFW_TRACE_SCOPE("LinkProgram");
+    handle = programFromSources(shaderSource(shader->GetVertexShader()),
+                                shaderSource(shader->GetFragmentShader()),
+                                shaderSource(shader->GetGeometryShader()));
+  }
+  if (!handle) {
+    // VTK compiles it again and reports what is wrong; nothing is stored
+    return this->Superclass::ReadyShaderProgram(shader, cap);
+  }
+  this->AdoptProgram(shader, handle);
+  this->StoreBinary(shader, key);
+  return this->Superclass::ReadyShaderProgram(shader, cap);
+}
+
+//------------------------------------------------------------------------------
+bool
+vtkGlfwShaderBinaryCache::IsAvailable()
+{
+  if (!this->Directory || !*this->Directory) {
+    return false;
+  }
+  auto internals = this->Internals;
+  if (internals->Available < 0) {
+    GLint formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    internals->Available = formats > 0 ? 1 : 0;
+
+    auto text = [](GLenum name) {
+      auto value = reinterpret_cast<const char*>(glGetString(name));
+      return std::string(value ? value : "");
+    };
+    internals->Device = text(GL_VENDOR) + "\n" + text(GL_RENDERER) + "\n" +
+                        text(GL_VERSION) + "\n";
+    if (!internals->Available) {
+      vtkDebugMacro(<< "The driver offers no program binary formats");
+    }
+  }
+  return internals->Available == 1;
+}
+
+//------------------------------------------------------------------------------
+uint64_t
+vtkGlfwShaderBinaryCache::GetProgramKey(vtkShaderProgram* shader)
+{
+  // the sources are final here, with every replacement already made
+  uint64_t hash = hashString(this->Internals->Device);
+  hash = hashString(shaderSource(shader->GetVertexShader()), hash);
+  hash = hashString(std::string(1, '\0'), hash);
+  hash = hashString(shaderSource(shader->GetFragmentShader()), hash);
+  hash = hashString(std::string(1, '\0'), hash);
+  hash = hashString(shaderSource(shader->GetGeometryShader()), hash);
+  return hash;
+}
+
+//------------------------------------------------------------------------------
+std::string
+vtkGlfwShaderBinaryCache::GetFilePath(uint64_t key, const char* extension)
+{
+  char name[17];
+  snprintf(
+    name, sizeof(name), "%016llx", static_cast<unsigned long long>(key));
+  return std::string(this->Directory) + "/" + name + extension;
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwShaderBinaryCache::AdoptProgram(vtkShaderProgram* shader,
+                                       unsigned int handle)
+{
+  ProgramAccess::Adopt(shader, static_cast<int>(handle));
+  shader->SetCompiled(true);
+}
+
+//------------------------------------------------------------------------------
+bool
+vtkGlfwShaderBinaryCache::LoadBinary(vtkShaderProgram* shader, uint64_t key)
+{
+  const std::string path = this->GetFilePath(key, BinaryExtension);
+  if (!vtksys::SystemTools::FileExists(path)) {
+    return false;
+  }
+  VTK_GLFW_TRACE_SCOPE("LoadProgramBinary");
+  GLuint handle = programFromBinary(path);
+  if (!handle) {
+    // stale or damaged, the compiled program will replace it
+    ++this->NumberOfRejected;
+    if (this->Internals->CurrentSize >= 0) {
+      this->Internals->CurrentSize -= vtksys::SystemTools::FileLength(path);
+    }
+    vtksys::SystemTools::RemoveFile(path);
+    return false;
+  }
+
+  this->AdoptProgram(shader, handle);
+  // recently used, the last to be evicted
+  vtksys::SystemTools::Touch(path, false);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwShaderBinaryCache::StoreBinary(vtkShaderProgram* shader, uint64_t key)
+{
+  VTK_GLFW_TRACE_SCOPE("StoreProgramBinary");
+  const GLuint handle = static_cast<GLuint>(shader->GetHandle());
+  GLint length = 0;
+  glGetProgramiv(handle, GL_PROGRAM_BINARY_LENGTH, &length);
+  if (length <= 0) {
+    return;
+  }
+  std::string binary(length, '\0');
+  GLsizei written = 0;
+  GLenum format = 0;
+  glGetProgramBinary(handle, length, &written, &format, &binary[0]);
+  if (written <= 0) {
+    return;
+  }
+  binary.resize(written);
+
+  vtksys::SystemTools::MakeDirectory(this->Directory);
+  const std::string path = this->GetFilePath(key, BinaryExtension);
+  BinaryHeader header = { Magic,
+                          Version,
+                          static_cast<uint32_t>(format),
+                          static_cast<uint32_t>(written) };
+  std::string head(reinterpret_cast<const char*>(&header), sizeof(header));
+  if (!writeFile(path, { head, binary })) {
+    vtkDebugMacro(<< "Unable to write " << path);
+    return;
+  }
+  ++this->NumberOfWrites;
+  vtkIdType size = sizeof(header) + written;
+
+  // the sources let WarmUp() rebuild the program once the binary is stale
+  const std::string sourcePath = this->GetFilePath(key, SourceExtension);
+  if (!vtksys::SystemTools::FileExists(sourcePath)) {
+    const std::string separator(1, '\0');
+    std::vector<std::string> parts = {
+      this->Internals->Device, separator,
+      shaderSource(shader->GetVertexShader()), separator,
+      shaderSource(shader->GetFragmentShader()), separator,
+      shaderSource(shader->GetGeometryShader())
+    };
+    if (writeFile(sourcePath, parts)) {
+      size += vtksys::SystemTools::FileLength(sourcePath);
+    }
+  }
+
+  auto internals = this->Internals;
+  if (internals->CurrentSize >= 0) {
+    internals->CurrentSize += size;
+  }
+  if (internals->CurrentSize < 0 ||
+      internals->CurrentSize > this->MaximumSize) {
+    this->Evict();
+  }
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwShaderBinaryCache::Evict()
+{
+  struct Entry
+  {
+    long Time;
+    vtkIdType Size;
+    std::string Stem;
+  };
+  std::vector<Entry> entries;
+  vtkIdType total = 0;
+  vtksys::Directory directory;
+  if (this->Directory && directory.Load(this->Directory)) {
+    const size_t extension = strlen(BinaryExtension);
+    for (unsigned long i = 0; i < directory.GetNumberOfFiles(); ++i) {
+      std::string name = directory.GetFile(i);
+      if (!endsWith(name, BinaryExtension)) {
+        continue;
+      }
+      std::string stem = std::string(this->Directory) + "/" +
+                         name.substr(0, name.size() - extension);
+      std::string binary = stem + BinaryExtension;
+      std::string source = stem + SourceExtension;
+      vtkIdType size = vtksys::SystemTools::FileLength(binary);
+      if (vtksys::SystemTools::FileExists(source)) {
+        size += vtksys::SystemTools::FileLength(source);
+      }
+      entries.push_back(
+        { vtksys::SystemTools::ModifiedTime(binary), size, stem });
+      total += size;
+    }
+  }
+
+  // oldest first
+  std::sort(entries.begin(),
+            entries.end(),
+            [](const Entry& a, const Entry& b) { return a.Time < b.Time; });
+  for (const Entry& entry : entries) {
+    if (total <= this->MaximumSize) {
+      break;
+    }
+    if (vtksys::SystemTools::RemoveFile(entry.Stem + BinaryExtension)) {
+      vtksys::SystemTools::RemoveFile(entry.Stem + SourceExtension);
+      total -= entry.Size;
+      ++this->NumberOfEvictions;
+    }
+  }
+  this->Internals->CurrentSize = total;
+}
+
+//------------------------------------------------------------------------------
+int
+vtkGlfwShaderBinaryCache::WarmUp(vtkGlfwUploadContext* context, int maximum)
+{
+  if (!context || maximum <= 0 || !this->IsAvailable()) {
+    return 0;
+  }
+  auto internals = this->Internals;
+  if (internals->WarmUpContext && internals->WarmUpContext != context) {
+    this->CancelWarmUp();
+  }
+  internals->WarmUpContext = context;
+
+  struct Entry
+  {
+    long Time;
+    uint64_t Key;
+  };
+  std::vector<Entry> entries;
+  vtksys::Directory directory;
+  if (directory.Load(this->Directory)) {
+    for (unsigned long i = 0; i < directory.GetNumberOfFiles(); ++i) {
+      std::string name = directory.GetFile(i);
+      if (!endsWith(name, SourceExtension)) {
+        continue;
+      }
+      char* end = nullptr;
+      uint64_t key = strtoull(name.c_str(), &end, 16);
+      if (end != name.c_str() + name.size() - strlen(SourceExtension)) {
+        continue;
+      }
+      std::string binary = this->GetFilePath(key, BinaryExtension);
+      std::string stamp = vtksys::SystemTools::FileExists(binary)
+                            ? binary
+                            : this->GetFilePath(key, SourceExtension);
+      entries.push_back({ vtksys::SystemTools::ModifiedTime(stamp), key });
+    }
+  }
+
+  // most recently used first, those are the likeliest to be asked for
+  std::sort(entries.begin(),
+            entries.end(),
+            [](const Entry& a, const Entry& b) { return a.Time > b.Time; });
+  int queued = 0;
+  for (const Entry& entry : entries) {
+    if (queued >= maximum) {
+      break;
+    }
+    if (internals->WarmUp.count(entry.Key)) {
+      continue;
+    }
+    std::string binary = this->GetFilePath(entry.Key, BinaryExtension);
+    std::string source = this->GetFilePath(entry.Key, SourceExtension);
+    std::string device = internals->Device;
+    vtkIdType ticket = context->LinkProgram([binary, source, device] {
+      return warmUpProgram(binary, source, device);
+    });
+    if (ticket < 0) {
+      break;
+    }
+    internals->WarmUp[entry.Key] = ticket;
+    ++queued;
+  }
+  vtkDebugMacro(<< "Warming up " << queued << " programs");
+  return queued;
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwShaderBinaryCache::CancelWarmUp()
+{
+  // the upload context deletes whatever was never acquired when it stops
+  auto internals = this->Internals;
+  internals->WarmUp.clear();
+  internals->Orphans.clear();
+  internals->WarmUpContext = nullptr;
+}
+
+//------------------------------------------------------------------------------
+int
+vtkGlfwShaderBinaryCache::GetNumberOfWarmUpPrograms()
+{
+  return static_cast<int>(this->Internals->WarmUp.size());
+}
+
+//------------------------------------------------------------------------------
+bool
+vtkGlfwShaderBinaryCache::AdoptWarmProgram(vtkShaderProgram* shader,
+                                           uint64_t key)
+{
+  auto internals = this->Internals;
+  auto it = internals->WarmUp.find(key);
+  if (it == internals->WarmUp.end()) {
+    return false;
+  }
+  vtkIdType ticket = it->second;
+  internals->WarmUp.erase(it);
+  auto context = internals->WarmUpContext;
+  if (!context->IsReady(ticket)) {
+    // compiling it here beats waiting behind the rest of the queue
+    internals->Orphans.push_back(ticket);
+    return false;
+  }
+  GLuint handle = context->Acquire(ticket);
+  if (!handle) {
+    return false;
+  }
+  this->AdoptProgram(shader, handle);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwShaderBinaryCache::DeleteOrphans()
+{
+  auto internals = this->Internals;
+  auto context = internals->WarmUpContext;
+  auto& orphans = internals->Orphans;
+  for (auto it = orphans.begin(); it != orphans.end();) {
+    if (context->IsReady(*it)) {
+      GLuint handle = context->Acquire(*it);
+      if (handle) {
+        glDeleteProgram(handle);
+      }
+      it = orphans.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwShaderBinaryCache::Clear()
+{
+  vtkIdType maximum = this->MaximumSize;
+  vtkIdType evictions = this->NumberOfEvictions;
+  this->MaximumSize = 0;
+  this->Evict();
+  this->MaximumSize = maximum;
+  this->NumberOfEvictions = evictions;
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwShaderBinaryCache::ResetStatistics()
+{
+  this->NumberOfHits = 0;
+  this->NumberOfWarmUpHits = 0;
+  this->NumberOfMisses = 0;
+  this->NumberOfRejected = 0;
+  this->NumberOfWrites = 0;
+  this->NumberOfEvictions = 0;
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwShaderBinaryCache::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+
+  os << indent << "Directory: "
+     << (this->Directory ? this->Directory : "(none)") << "\n";
+  os << indent << "MaximumSize: " << this->MaximumSize << "\n";
+  os << indent << "NumberOfHits: " << this->NumberOfHits << "\n";
+  os << indent << "NumberOfWarmUpHits: " << this->NumberOfWarmUpHits << "\n";
+  os << indent << "NumberOfMisses: " << this->NumberOfMisses << "\n";
+  os << indent << "NumberOfRejected: " << this->NumberOfRejected << "\n";
+  os << indent << "NumberOfWrites: " << this->NumberOfWrites << "\n";
+  os << indent << "NumberOfEvictions: " << this->NumberOfEvictions << "\n";
+  os << indent << "WarmUpPrograms: " << this->GetNumberOfWarmUpPrograms()
+     << "\n";
+}
@@ -0,0 +1,361 @@
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <new>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "vtkCommand.h"
+#include "vtkObjectFactory.h"
+
+// clang-format off
+#include "vtkGlfwOpenGLRenderWindow.h"
+#include "vtkGlfwSharedFrameExporter.h"
+#include "vtkGlfwSharedFrameProtocol.h"
+#include "vtkGlfwTrace.h"
+// clang-format on
+
+using namespace vtkGlfwSharedFrame;
+
+namespace {
+uint64_t
+slotStride(int width, int height, bool depth)
+{
+  const uint64_t pixels = uint64_t(width) * height;
+  return Align(sizeof(SlotHeader)) + Align(pixels * 4) +
+         (depth ? Align(pixels * sizeof(float)) : 0);
+}
+
+uint64_t
+monotonicNow()
+{
+  timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return uint64_t(now.tv_sec) * 1000000000u + now.tv_nsec;
+}
+}
+
+class vtkGlfwSharedFrameExporter::vtkInternals
+{
+public:
+  std::string Name;
+  unsigned char* Base = nullptr;
+  size_t Size = 0;
+  uint64_t SlotStride = 0;
+  uint64_t Sequence = 0;
+  // when each frame still being read back by the window was finished
+  std::deque<uint64_t> Timestamps;
+
+  RingHeader* Ring() { return reinterpret_cast<RingHeader*>(this->Base); }
+
+  SlotHeader* Slot(uint64_t sequence)
+  {
+    auto ring = this->Ring();
+    return reinterpret_cast<SlotHeader*>(
+      this->Base + ring->SlotsOffset +
+      (sequence % ring->NumberOfSlots) * ring->SlotStride);
+  }
+
+  // replaces whatever is mapped or left under Name; false sets errno
+  bool Create(int slots, uint64_t slotStride)
+  {
+    this->Close();
+    shm_unlink(this->Name.c_str());
+    const int flags = O_CREAT | O_EXCL | O_RDWR;
+    int fd = shm_open(this->Name.c_str(), flags, S_IRUSR | S_IWUSR);
+    if (fd < 0) {
+      return false;
+    }
+    const uint64_t slotsOffset = Align(sizeof(RingHeader));
+    const size_t size = slotsOffset + slots * slotStride;
+    void* base = MAP_FAILED;
+    if (ftruncate(fd, size) == 0) {
+      base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    int error = errno;
+    close(fd);
+    if (base == MAP_FAILED) {
+      shm_unlink(this->Name.c_str());
+      errno = error;
+      return false;
+    }
+    this->Base = static_cast<unsigned char*>(base);
+    this->Size = size;
+    this->SlotStride = slotStride;
+
+    // the object starts out zeroed, which is what the atomics hold
+    auto ring = new (this->Base) RingHeader;
+    ring->Version = Version;
+    ring->NumberOfSlots = slots;
+    ring->Closed.store(0, std::memory_order_relaxed);
+    ring->SlotsOffset = slotsOffset;
+    ring->SlotStride = slotStride;
+    ring->Latest.store(0, std::memory_order_relaxed);
+    for (int i = 0; i < slots; ++i) {
+      auto slot = new (this->Base + slotsOffset + i * slotStride) SlotHeader;
+      slot->Lock.store(0, std::memory_order_relaxed);
+    }
+    ring->Magic.store(Magic, std::memory_order_release);
+    return true;
+  }
+
+  // publish a frame in the next slot, growing the ring if it does not fit;
+  // false sets errno
+  bool Write(const vtkGlfwOpenGLRenderWindow::FramePixels& pixels,
+             uint64_t timestamp)
+  {
+    const bool depth = pixels.Depth != nullptr;
+    const uint64_t stride = slotStride(pixels.Width, pixels.Height, depth);
+    if (stride > this->SlotStride) {
+      // room for the new size and no more, a window rarely keeps growing
+      if (!this->Create(this->Ring()->NumberOfSlots, stride)) {
+        return false;
+      }
+    }
+
+    const uint64_t sequence = this->Sequence + 1;
+    SlotHeader* slot = this->Slot(sequence);
+    auto bytes = reinterpret_cast<unsigned char*>(slot);
+    slot->Lock.store(2 * sequence - 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    const uint64_t count = uint64_t(pixels.Width) * pixels.Height;
+    slot->Sequence = sequence;
+    slot->Timestamp = timestamp;
+    slot->Width = pixels.Width;
+    slot->Height = pixels.Height;
+    slot->ColorOffset = Align(sizeof(SlotHeader));
+    slot->ColorSize = count * 4;
+    slot->DepthOffset = depth ? slot->ColorOffset + Align(slot->ColorSize) : 0;
+    slot->DepthSize = depth ? count * sizeof(float) : 0;
+    std::memcpy(bytes + slot->ColorOffset, pixels.Color, slot->ColorSize);
+    if (depth) {
+      std::memcpy(bytes + slot->DepthOffset, pixels.Depth, slot->DepthSize);
+    }
+
+    slot->Lock.store(2 * sequence, std::memory_order_release);
+    this->Ring()->Latest.store(sequence, std::memory_order_release);
+    this->Sequence = sequence;
+    return true;
+  }
+
+  // readers still mapping the ring see it closed and reopen by name
+  void Close()
+  {
+    if (!this->Base) {
+      return;
+    }
+    this->Ring()->Closed.store(1, std::memory_order_release);
+    munmap(this->Base, this->Size);
+    this->Base = nullptr;
+    this->Size = 0;
+    this->SlotStride = 0;
+  }
+};
+
+vtkStandardNewMacro(vtkGlfwSharedFrameExporter);
+
+//------------------------------------------------------------------------------
+vtkGlfwSharedFrameExporter::vtkGlfwSharedFrameExporter()
+  : RenderWindow(nullptr)
+  , FrameObserver(0)
+  , NumberOfSlots(3)
+  , ExportDepth(false)
+  , Internals(new vtkInternals)
+{}
+
+//------------------------------------------------------------------------------
+vtkGlfwSharedFrameExporter::~vtkGlfwSharedFrameExporter()
+{
+  this->Stop();
+  this->SetRenderWindow(nullptr);
+  delete this->Internals;
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwSharedFrameExporter::SetRenderWindow(vtkGlfwOpenGLRenderWindow* window)
+{
+  if (this->RenderWindow == window) {
+    return;
+  }
+  if (this->RenderWindow) {
+    this->DropReadbacks();
+    this->RenderWindow->RemoveObserver(this->FrameObserver);
+    this->RenderWindow->UnRegister(this);
+  }
+  this->RenderWindow = window;
+  if (this->RenderWindow) {
+    this->RenderWindow->Register(this);
+    this->FrameObserver =
+      this->RenderWindow->AddObserver(vtkCommand::WindowFrameEvent,
+                                      this,
+                                      &vtkGlfwSharedFrameExporter::OnFrame);
+  }
+  this->Modified();
+}
+
+//------------------------------------------------------------------------------
+bool
+vtkGlfwSharedFrameExporter::Start(const char* name)
+{
+  if (!name || !*name) {
+    vtkErrorMacro(<< "A shared memory name is required.");
+    return false;
+  }
+  this->Stop();
+
+  // sized for the window as it is now, so readers can open it right away
+  int width = 0, height = 0;
+  if (this->RenderWindow) {
+    width = this->RenderWindow->GetSize()[0];
+    height = this->RenderWindow->GetSize()[1];
+  }
+  auto internals = this->Internals;
+  internals->Name = name;
+  internals->Sequence = 0;
+  if (!internals->Create(this->NumberOfSlots,
+                         slotStride(width, height, this->ExportDepth))) {
+    vtkErrorMacro(<< "Unable to create shared memory " << name << ": "
+                  << strerror(errno));
+    internals->Name.clear();
+    return false;
+  }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwSharedFrameExporter::Stop()
+{
+  auto internals = this->Internals;
+  if (!internals->Base) {
+    return;
+  }
+  this->DropReadbacks();
+  internals->Close();
+  shm_unlink(internals->Name.c_str());
+  internals->Name.clear();
+}
+
+//------------------------------------------------------------------------------
+bool
+vtkGlfwSharedFrameExporter::IsStarted()
+{
+  return this->Internals->Base != nullptr;
+}
+
+//------------------------------------------------------------------------------
+vtkIdType
+vtkGlfwSharedFrameExporter::GetNumberOfFramesExported()
+{
+  return static_cast<vtkIdType>(this->Internals->Sequence);
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwSharedFrameExporter::Flush()
+{
+  if (this->Internals->Base) {
+    this->Publish(true);
+  }
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwSharedFrameExporter::OnFrame(vtkObject*, unsigned long, void*)
+{
+  auto internals = this->Internals;
+  if (!internals->Base) {
+    return;
+  }
+  const int* size = this->RenderWindow->GetSize();
+  if (size[0] <= 0 || size[1] <= 0) {
+    return;
+  }
+  VTK_GLFW_TRACE_SCOPE("ExportSharedFrame");
+
+  // make room with whatever the GPU has finished meanwhile
+  this->Publish(false);
+  // with every readback in flight the GPU is frames behind, so this frame
+  // is skipped rather than waited for
+  if (this->RenderWindow->StartFrameReadback(this->ExportDepth)) {
+    internals->Timestamps.push_back(monotonicNow());
+  }
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwSharedFrameExporter::Publish(bool wait)
+{
+  auto internals = this->Internals;
+  auto& timestamps = internals->Timestamps;
+  vtkGlfwOpenGLRenderWindow::FramePixels pixels;
+  for (;;) {
+    // the window drops its readbacks with its graphics resources, and
+    // one that failed to map
+    const int pending =
+      this->RenderWindow ? this->RenderWindow->GetNumberOfFrameReadbacks() : 0;
+    while (timestamps.size() > size_t(pending)) {
+      timestamps.pop_front();
+    }
+    if (timestamps.empty()) {
+      return;
+    }
+    if (!this->RenderWindow->MapFrameReadback(pixels, wait)) {
+      if (!wait) {
+        return;
+      }
+      // a failed map drops the readback; anything else will not improve
+      if (this->RenderWindow->GetNumberOfFrameReadbacks() == pending) {
+        this->DropReadbacks();
+        return;
+      }
+      continue;
+    }
+    const uint64_t timestamp = timestamps.front();
+    timestamps.pop_front();
+    bool written = !internals->Base || internals->Write(pixels, timestamp);
+    this->RenderWindow->FinishFrameReadback();
+    if (!written) {
+      vtkErrorMacro(<< "Unable to grow shared memory " << internals->Name
+                    << ": " << strerror(errno));
+      internals->Name.clear();
+      this->DropReadbacks();
+      return;
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwSharedFrameExporter::DropReadbacks()
+{
+  auto& timestamps = this->Internals->Timestamps;
+  if (this->RenderWindow) {
+    int pending = this->RenderWindow->GetNumberOfFrameReadbacks();
+    for (size_t i = 0; i < timestamps.size() && pending > 0; ++i, --pending) {
+      this->RenderWindow->FinishFrameReadback();
+    }
+  }
+  timestamps.clear();
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwSharedFrameExporter::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+
+  os << indent << "RenderWindow: " << this->RenderWindow << "\n";
+  os << indent << "Name: " << this->Internals->Name << "\n";
+  os << indent << "NumberOfSlots: " << this->NumberOfSlots << "\n";
+  os << indent << "ExportDepth: " << this->ExportDepth << "\n";
+  os << indent << "NumberOfFramesExported: "
+     << this->GetNumberOfFramesExported() << "\n";
+}
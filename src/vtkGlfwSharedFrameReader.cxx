@@ -0,0 +1,277 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "vtkObjectFactory.h"
+
+// clang-format off
+#include "vtkGlfwSharedFrameProtocol.h"
+#include "vtkGlfwSharedFrameReader.h"
+// clang-format on
+
+using namespace vtkGlfwSharedFrame;
+
+class vtkGlfwSharedFrameReader::vtkInternals
+{
+public:
+  std::string Name;
+  const unsigned char* Base = nullptr;
+  size_t Size = 0;
+
+  const RingHeader* Ring()
+  {
+    return reinterpret_cast<const RingHeader*>(this->Base);
+  }
+
+  const SlotHeader* Slot(uint64_t sequence)
+  {
+    auto ring = this->Ring();
+    return reinterpret_cast<const SlotHeader*>(
+      this->Base + ring->SlotsOffset +
+      (sequence % ring->NumberOfSlots) * ring->SlotStride);
+  }
+
+  bool Map()
+  {
+    int fd = shm_open(this->Name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+      return false;
+    }
+    struct stat info;
+    void* base = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && info.st_size >= off_t(sizeof(RingHeader))) {
+      base = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (base == MAP_FAILED) {
+      return false;
+    }
+    this->Base = static_cast<const unsigned char*>(base);
+    this->Size = info.st_size;
+
+    // an exporter may still be setting it up
+    auto ring = this->Ring();
+    if (ring->Magic.load(std::memory_order_acquire) != Magic ||
+        ring->Version != Version || ring->NumberOfSlots == 0 ||
+        ring->SlotStride < sizeof(SlotHeader) ||
+        ring->SlotsOffset + ring->NumberOfSlots * ring->SlotStride >
+          this->Size) {
+      this->Unmap();
+      return false;
+    }
+    return true;
+  }
+
+  void Unmap()
+  {
+    if (this->Base) {
+      munmap(const_cast<unsigned char*>(this->Base), this->Size);
+    }
+    this->Base = nullptr;
+    this->Size = 0;
+  }
+
+  // the slot's layout, if it fits the ring; the exporter is trusted with
+  // the pixels, not with the bounds of our mapping
+  bool Describe(const SlotHeader* slot, Frame& frame)
+  {
+    const uint64_t stride = this->Ring()->SlotStride;
+    const uint64_t pixels = uint64_t(slot->Width) * slot->Height;
+    if (slot->ColorSize != pixels * 4 ||
+        slot->ColorOffset + slot->ColorSize > stride ||
+        (slot->DepthSize && (slot->DepthSize != pixels * sizeof(float) ||
+                             slot->DepthOffset + slot->DepthSize > stride))) {
+      return false;
+    }
+    auto bytes = reinterpret_cast<const unsigned char*>(slot);
+    frame.Sequence = slot->Sequence;
+    frame.Timestamp = slot->Timestamp;
+    frame.Width = static_cast<int>(slot->Width);
+    frame.Height = static_cast<int>(slot->Height);
+    frame.Color = bytes + slot->ColorOffset;
+    frame.Depth = slot->DepthSize
+                    ? reinterpret_cast<const float*>(bytes + slot->DepthOffset)
+                    : nullptr;
+    return true;
+  }
+};
+
+vtkStandardNewMacro(vtkGlfwSharedFrameReader);
+
+//------------------------------------------------------------------------------
+vtkGlfwSharedFrameReader::vtkGlfwSharedFrameReader()
+  : Internals(new vtkInternals)
+{}
+
+//------------------------------------------------------------------------------
+vtkGlfwSharedFrameReader::~vtkGlfwSharedFrameReader()
+{
+  this->Close();
+  delete this->Internals;
+}
+
+//------------------------------------------------------------------------------
+bool
+vtkGlfwSharedFrameReader::Open(const char* name)
+{
+  this->Close();
+  if (!name || !*name) {
+    return false;
+  }
+  this->Internals->Name = name;
+  if (!this->Internals->Map()) {
+    this->Internals->Name.clear();
+    return false;
+  }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwSharedFrameReader::Close()
+{
+  this->Internals->Unmap();
+  this->Internals->Name.clear();
+}
+
+//------------------------------------------------------------------------------
+bool
+vtkGlfwSharedFrameReader::IsOpen()
+{
+  return this->Internals->Base != nullptr;
+}
+
+//------------------------------------------------------------------------------
+bool
+vtkGlfwSharedFrameReader::Refresh()
+{
+  auto internals = this->Internals;
+  if (internals->Name.empty()) {
+    return false;
+  }
+  if (internals->Base &&
+      internals->Ring()->Closed.load(std::memory_order_acquire)) {
+    internals->Unmap();
+  }
+  // keeps trying until the exporter is back
+  return internals->Base || internals->Map();
+}
+
+//------------------------------------------------------------------------------
+bool
+vtkGlfwSharedFrameReader::Peek(Frame& frame)
+{
+  if (!this->Refresh()) {
+    return false;
+  }
+  auto internals = this->Internals;
+  // a few tries, the newest slot is only contended if the reader lagged
+  for (int attempt = 0; attempt < 4; ++attempt) {
+    const uint64_t sequence =
+      internals->Ring()->Latest.load(std::memory_order_acquire);
+    if (sequence == 0) {
+      return false;
+    }
+    const SlotHeader* slot = internals->Slot(sequence);
+    const uint64_t lock = slot->Lock.load(std::memory_order_acquire);
+    if (lock != 2 * sequence || !internals->Describe(slot, frame)) {
+      continue;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot->Lock.load(std::memory_order_relaxed) == lock) {
+      return true;
+    }
+  }
+  return false;
+}
+
+//------------------------------------------------------------------------------
+bool
+vtkGlfwSharedFrameReader::IsValid(const Frame& frame)
+{
+  auto internals = this->Internals;
+  // a frame from a ring that has since been replaced is gone
+  if (!internals->Base || frame.Sequence == 0 ||
+      frame.Color < internals->Base ||
+      frame.Color >= internals->Base + internals->Size) {
+    return false;
+  }
+  std::atomic_thread_fence(std::memory_order_acquire);
+  const SlotHeader* slot = internals->Slot(frame.Sequence);
+  return slot->Lock.load(std::memory_order_relaxed) == 2 * frame.Sequence;
+}
+
+//------------------------------------------------------------------------------
+bool
+vtkGlfwSharedFrameReader::Read(Frame& frame,
+                               std::vector<unsigned char>& color,
+                               std::vector<float>& depth)
+{
+  for (int attempt = 0; attempt < 16; ++attempt) {
+    Frame shared;
+    if (!this->Peek(shared)) {
+      return false;
+    }
+    const size_t pixels = size_t(shared.Width) * shared.Height;
+    color.resize(pixels * 4);
+    std::memcpy(color.data(), shared.Color, color.size());
+    depth.resize(shared.Depth ? pixels : 0);
+    if (shared.Depth) {
+      std::memcpy(depth.data(), shared.Depth, depth.size() * sizeof(float));
+    }
+    if (this->IsValid(shared)) {
+      frame = shared;
+      frame.Color = color.data();
+      frame.Depth = shared.Depth ? depth.data() : nullptr;
+      return true;
+    }
+  }
+  return false;
+}
+
+//------------------------------------------------------------------------------
+bool
+vtkGlfwSharedFrameReader::WaitForFrame(uint64_t sequence, double timeout)
+{
+  using Clock = std::chrono::steady_clock;
+  const auto start = Clock::now();
+  auto pause = std::chrono::microseconds(50);
+  for (;;) {
+    if (this->Refresh() &&
+        this->Internals->Ring()->Latest.load(std::memory_order_acquire) >
+          sequence) {
+      return true;
+    }
+    if (timeout >= 0.0 &&
+        std::chrono::duration<double>(Clock::now() - start).count() >=
+          timeout) {
+      return false;
+    }
+    std::this_thread::sleep_for(pause);
+    pause = std::min(pause * 2, std::chrono::microseconds(1000));
+  }
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwSharedFrameReader::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+
+  auto internals = this->Internals;
+  os << indent << "Name: " << internals->Name << "\n";
+  os << indent << "Open: " << (internals->Base != nullptr) << "\n";
+  if (internals->Base) {
+    os << indent << "NumberOfSlots: " << internals->Ring()->NumberOfSlots
+       << "\n";
+    os << indent << "Latest: "
+       << internals->Ring()->Latest.load(std::memory_order_relaxed) << "\n";
+  }
+}
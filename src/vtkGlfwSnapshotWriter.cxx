@@ -0,0 +1,184 @@
+#include "vtkGlfwSnapshotWriter.h"
+
+#include "vtkObject.h"
+#include "vtk_png.h"
+
+#include <cstdio>
+
+namespace {
+struct PNGSinkData
+{
+  const vtkGlfwSnapshotWriter::Sink* Sink;
+  bool Failed;
+};
+
+void
+pngWrite(png_structp png, png_bytep data, png_size_t size)
+{
+  auto sinkData = static_cast<PNGSinkData*>(png_get_io_ptr(png));
+  if (!sinkData->Failed && !(*sinkData->Sink)(data, size)) {
+    sinkData->Failed = true;
+  }
+}
+
+void
+pngFlush(png_structp)
+{}
+}
+
+//------------------------------------------------------------------------------
+vtkGlfwSnapshotWriter::vtkGlfwSnapshotWriter(int numberOfThreads,
+                                             int maximumPending)
+  : InFlight(0)
+  , MaximumPending(maximumPending < 1 ? 1 : maximumPending)
+  , Workers(numberOfThreads)
+{}
+
+//------------------------------------------------------------------------------
+vtkGlfwSnapshotWriter::~vtkGlfwSnapshotWriter()
+{
+  this->Wait();
+}
+
+//------------------------------------------------------------------------------
+std::unique_ptr<vtkGlfwSnapshotWriter::Buffer>
+vtkGlfwSnapshotWriter::AcquireBuffer(size_t size)
+{
+  std::unique_ptr<Buffer> buffer;
+  {
+    std::unique_lock<std::mutex> lock(this->Mutex);
+    this->Returned.wait(
+      lock, [this] { return this->InFlight < this->MaximumPending; });
+    ++this->InFlight;
+    if (!this->FreeBuffers.empty()) {
+      buffer = std::move(this->FreeBuffers.back());
+      this->FreeBuffers.pop_back();
+    }
+  }
+  if (!buffer) {
+    buffer.reset(new Buffer);
+  }
+  // keeps its capacity, so same-sized frames never reallocate
+  buffer->resize(size);
+  return buffer;
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwSnapshotWriter::ReleaseBuffer(std::unique_ptr<Buffer> buffer)
+{
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    --this->InFlight;
+    this->FreeBuffers.push_back(std::move(buffer));
+  }
+  this->Returned.notify_one();
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwSnapshotWriter::Write(std::unique_ptr<Buffer> pixels,
+                             int width,
+                             int height,
+                             int components,
+                             int compressionLevel,
+                             const std::string& fileName)
+{
+  this->Workers.Submit(
+    std::move(pixels),
+    [this, width, height, components, compressionLevel, fileName](
+      std::unique_ptr<Buffer> buffer) {
+      FILE* fp = fopen(fileName.c_str(), "wb");
+      if (!fp) {
+        vtkGenericWarningMacro(<< "Unable to open " << fileName
+                               << " for writing.");
+      } else {
+        bool ok = vtkGlfwSnapshotWriter::EncodePNG(
+          buffer->data(),
+          width,
+          height,
+          components,
+          compressionLevel,
+          [fp](const unsigned char* data, size_t size) {
+            return fwrite(data, 1, size, fp) == size;
+          });
+        if (fclose(fp) != 0 || !ok) {
+          vtkGenericWarningMacro(<< "Failed to write snapshot " << fileName);
+        }
+      }
+      this->ReleaseBuffer(std::move(buffer));
+    });
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwSnapshotWriter::Wait()
+{
+  this->Workers.Wait();
+}
+
+//------------------------------------------------------------------------------
+bool
+vtkGlfwSnapshotWriter::EncodePNG(const unsigned char* pixels,
+                                 int width,
+                                 int height,
+                                 int components,
+                                 int compressionLevel,
+                                 const Sink& sink)
+{
+  int colorType;
+  switch (components) {
+    case 1:
+      colorType = PNG_COLOR_TYPE_GRAY;
+      break;
+    case 3:
+      colorType = PNG_COLOR_TYPE_RGB;
+      break;
+    case 4:
+      colorType = PNG_COLOR_TYPE_RGB_ALPHA;
+      break;
+    default:
+      return false;
+  }
+
+  png_structp png =
+    png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
+  if (!png) {
+    return false;
+  }
+  png_infop info = png_create_info_struct(png);
+  if (!info) {
+    png_destroy_write_struct(&png, nullptr);
+    return false;
+  }
+
+  // rows are referenced in place, last row first, so no flipped copy of
+  // the image is ever made
+  std::vector<png_bytep> rows(height);
+  const size_t rowBytes = size_t(width) * components;
+  for (int i = 0; i < height; ++i) {
+    rows[i] = const_cast<png_bytep>(pixels + (height - 1 - i) * rowBytes);
+  }
+
+  PNGSinkData sinkData = { &sink, false };
+  if (setjmp(png_jmpbuf(png))) {
+    png_destroy_write_struct(&png, &info);
+    return false;
+  }
+  png_set_write_fn(png, &sinkData, pngWrite, pngFlush);
+  png_set_compression_level(png, compressionLevel);
+  png_set_IHDR(png,
+               info,
+               width,
+               height,
+               8,
+               colorType,
+               PNG_INTERLACE_NONE,
+               PNG_COMPRESSION_TYPE_DEFAULT,
+               PNG_FILTER_TYPE_DEFAULT);
+  png_write_info(png, info);
+  png_write_image(png, rows.data());
+  png_write_end(png, info);
+  png_destroy_write_struct(&png, &info);
+  return !sinkData.Failed;
+}
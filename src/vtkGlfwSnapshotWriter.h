@@ -0,0 +1,83 @@
+#ifndef vtkGlfwSnapshotWriter_h
+#define vtkGlfwSnapshotWriter_h
+
+#include "vtkGlfwWorkerPool.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * Encodes frames read back from a render window to PNG on a worker pool.
+ *
+ * Pixel buffers come from a pool and go back to it once written, so a burst
+ * of snapshots allocates nothing after warm-up. Buffers hold rows in OpenGL
+ * order (bottom row first); the encoder walks them top-down, so the flip
+ * happens while libpng copies each row rather than as a separate pass.
+ */
+class vtkGlfwSnapshotWriter
+{
+public:
+  using Buffer = std::vector<unsigned char>;
+  using Sink = std::function<bool(const unsigned char* data, size_t size)>;
+
+  vtkGlfwSnapshotWriter(int numberOfThreads, int maximumPending);
+  ~vtkGlfwSnapshotWriter();
+
+  /**
+   * Take a buffer of at least size bytes from the pool. Blocks while
+   * maximumPending buffers are waiting to be written.
+   */
+  std::unique_ptr<Buffer> AcquireBuffer(size_t size);
+
+  /**
+   * Give back a buffer from AcquireBuffer() that is not going to be
+   * written after all.
+   */
+  void ReleaseBuffer(std::unique_ptr<Buffer> buffer);
+
+  /**
+   * Encode pixels, width x height with the given number of 8 bit
+   * components in bottom-up row order, and write them to fileName on a
+   * worker. The buffer returns to the pool afterwards.
+   */
+  void Write(std::unique_ptr<Buffer> pixels,
+             int width,
+             int height,
+             int components,
+             int compressionLevel,
+             const std::string& fileName);
+
+  /**
+   * Block until every queued snapshot has been written.
+   */
+  void Wait();
+
+  /**
+   * Encode bottom-up pixels as PNG and hand the bytes to sink as libpng
+   * produces them. Returns false if encoding or the sink failed.
+   */
+  static bool EncodePNG(const unsigned char* pixels,
+                        int width,
+                        int height,
+                        int components,
+                        int compressionLevel,
+                        const Sink& sink);
+
+private:
+  vtkGlfwSnapshotWriter(const vtkGlfwSnapshotWriter&) = delete;
+  void operator=(const vtkGlfwSnapshotWriter&) = delete;
+
+  std::mutex Mutex;
+  std::condition_variable Returned;
+  std::vector<std::unique_ptr<Buffer>> FreeBuffers;
+  int InFlight;
+  int MaximumPending;
+  vtkGlfwWorkerPool Workers;
+};
+
+#endif
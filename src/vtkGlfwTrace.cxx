@@ -0,0 +1,271 @@
+#include "vtkGlfwTrace.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace {
+struct Event
+{
+  const char* Name;
+  int64_t Start;
+  int64_t Duration;
+};
+
+const size_t ChunkSize = 4096;
+// about 24 MB per thread, later spans are counted as dropped
+const size_t MaximumChunks = 256;
+
+struct Chunk
+{
+  Event Events[ChunkSize];
+  // published with release by the writer once an event is complete
+  std::atomic<size_t> Count{ 0 };
+  // set only after Count reached ChunkSize
+  std::atomic<Chunk*> Next{ nullptr };
+};
+
+struct ThreadBuffer
+{
+  ThreadBuffer(unsigned int id)
+    : Tail(new Chunk)
+    , Head(Tail)
+    , Id(id)
+  {}
+  ~ThreadBuffer()
+  {
+    while (this->Head) {
+      Chunk* next = this->Head->Next.load();
+      delete this->Head;
+      this->Head = next;
+    }
+  }
+
+  // owning thread only
+  Chunk* Tail;
+  // flushing thread only, under the registry mutex
+  Chunk* Head;
+  size_t Consumed = 0;
+
+  std::atomic<size_t> Chunks{ 1 };
+  std::atomic<uint64_t> Dropped{ 0 };
+  unsigned int Id;
+  // under the registry mutex
+  std::string Name;
+};
+
+struct Registry
+{
+  // guards Buffers, File and everything the flush touches
+  std::mutex Mutex;
+  std::vector<std::unique_ptr<ThreadBuffer>> Buffers;
+  FILE* File = nullptr;
+  bool FirstEvent = true;
+  unsigned int NextThreadId = 1;
+  const std::chrono::steady_clock::time_point Epoch =
+    std::chrono::steady_clock::now();
+};
+
+Registry&
+registry()
+{
+  static Registry instance;
+  return instance;
+}
+
+thread_local ThreadBuffer* LocalBuffer = nullptr;
+
+ThreadBuffer*
+localBuffer()
+{
+  if (!LocalBuffer) {
+    // once per thread; buffers outlive their threads so nothing is lost
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.Mutex);
+    reg.Buffers.emplace_back(new ThreadBuffer(reg.NextThreadId++));
+    LocalBuffer = reg.Buffers.back().get();
+  }
+  return LocalBuffer;
+}
+
+void
+writeSeparator(Registry& reg)
+{
+  fputs(reg.FirstEvent ? "\n" : ",\n", reg.File);
+  reg.FirstEvent = false;
+}
+
+void
+flushLocked(Registry& reg)
+{
+  for (auto& buffer : reg.Buffers) {
+    for (;;) {
+      Chunk* chunk = buffer->Head;
+      // Next first: once it is set, Count is final
+      Chunk* next = chunk->Next.load(std::memory_order_acquire);
+      size_t count = chunk->Count.load(std::memory_order_acquire);
+      if (reg.File) {
+        for (size_t i = buffer->Consumed; i < count; ++i) {
+          const Event& event = chunk->Events[i];
+          writeSeparator(reg);
+          fprintf(reg.File,
+                  "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,"
+                  "\"ts\":%.3f,\"dur\":%.3f}",
+                  event.Name,
+                  buffer->Id,
+                  event.Start / 1000.0,
+                  event.Duration / 1000.0);
+        }
+      }
+      buffer->Consumed = count;
+      if (!next) {
+        break;
+      }
+      // the writer has moved on, the chunk is ours to free
+      delete chunk;
+      buffer->Head = next;
+      buffer->Consumed = 0;
+      buffer->Chunks.fetch_sub(1, std::memory_order_relaxed);
+    }
+  }
+  if (reg.File) {
+    fflush(reg.File);
+  }
+}
+
+void
+closeLocked(Registry& reg)
+{
+  if (!reg.File) {
+    return;
+  }
+  flushLocked(reg);
+  for (auto& buffer : reg.Buffers) {
+    if (!buffer->Name.empty()) {
+      writeSeparator(reg);
+      fprintf(reg.File,
+              "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,"
+              "\"args\":{\"name\":\"%s\"}}",
+              buffer->Id,
+              buffer->Name.c_str());
+    }
+    uint64_t dropped = buffer->Dropped.exchange(0);
+    if (dropped) {
+      fprintf(stderr,
+              "vtkGlfwTrace: dropped %llu spans on thread %u\n",
+              static_cast<unsigned long long>(dropped),
+              buffer->Id);
+    }
+  }
+  fputs("\n]\n", reg.File);
+  fclose(reg.File);
+  reg.File = nullptr;
+}
+
+// VTKGLFW_TRACE=file.json traces the whole run
+struct EnvironmentTrace
+{
+  EnvironmentTrace()
+  {
+    // constructed first so it is destroyed after us
+    registry();
+    const char* fileName = getenv("VTKGLFW_TRACE");
+    if (fileName && *fileName) {
+      vtkGlfwTrace::Start(fileName);
+    }
+  }
+  ~EnvironmentTrace() { vtkGlfwTrace::Stop(); }
+};
+EnvironmentTrace environmentTrace;
+}
+
+std::atomic<bool> vtkGlfwTrace::Enabled{ false };
+
+//------------------------------------------------------------------------------
+bool
+vtkGlfwTrace::Start(const char* fileName)
+{
+  if (!fileName) {
+    return false;
+  }
+  auto& reg = registry();
+  std::lock_guard<std::mutex> lock(reg.Mutex);
+  Enabled = false;
+  closeLocked(reg);
+  // whatever was recorded before belongs to no file
+  flushLocked(reg);
+
+  reg.File = fopen(fileName, "w");
+  if (!reg.File) {
+    fprintf(stderr, "vtkGlfwTrace: unable to open %s\n", fileName);
+    return false;
+  }
+  fputs("[", reg.File);
+  reg.FirstEvent = true;
+  Enabled = true;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwTrace::Stop()
+{
+  Enabled = false;
+  auto& reg = registry();
+  std::lock_guard<std::mutex> lock(reg.Mutex);
+  closeLocked(reg);
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwTrace::Flush()
+{
+  auto& reg = registry();
+  std::lock_guard<std::mutex> lock(reg.Mutex);
+  flushLocked(reg);
+}
+
+//------------------------------------------------------------------------------
+int64_t
+vtkGlfwTrace::Now()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+           std::chrono::steady_clock::now() - registry().Epoch)
+    .count();
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwTrace::Record(const char* name, int64_t start, int64_t end)
+{
+  ThreadBuffer* buffer = localBuffer();
+  Chunk* chunk = buffer->Tail;
+  size_t count = chunk->Count.load(std::memory_order_relaxed);
+  if (count == ChunkSize) {
+    if (buffer->Chunks.load(std::memory_order_relaxed) >= MaximumChunks) {
+      buffer->Dropped.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    Chunk* next = new Chunk;
+    buffer->Chunks.fetch_add(1, std::memory_order_relaxed);
+    chunk->Next.store(next, std::memory_order_release);
+    buffer->Tail = chunk = next;
+    count = 0;
+  }
+  chunk->Events[count] = { name, start, end - start };
+  chunk->Count.store(count + 1, std::memory_order_release);
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwTrace::SetThreadName(const char* name)
+{
+  ThreadBuffer* buffer = localBuffer();
+  auto& reg = registry();
+  std::lock_guard<std::mutex> lock(reg.Mutex);
+  buffer->Name = name ? name : "";
+}
@@ -0,0 +1,313 @@
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "vtkObjectFactory.h"
+#include "vtk_glew.h"
+
+// clang-format off
+#include "vtkGlfwOpenGLRenderWindow.h"
+#include "vtkGlfwTrace.h"
+#include "vtkGlfwUploadContext.h"
+// clang-format on
+
+class vtkGlfwUploadContext::vtkInternals
+{
+public:
+  struct Result
+  {
+    GLuint Name = 0;
+    GLenum Kind = GL_BUFFER;
+    GLsync Fence = nullptr;
+  };
+
+  std::mutex Mutex;
+  std::condition_variable Wake;
+  std::condition_variable Done;
+  std::deque<std::pair<vtkIdType, std::function<Result()>>> Queue;
+  std::map<vtkIdType, Result> Results;
+  std::thread Worker;
+  vtkIdType NextTicket = 0;
+  bool Running = false;
+  bool Quit = false;
+
+  vtkIdType Enqueue(std::function<Result()> job)
+  {
+    vtkIdType ticket;
+    {
+      std::lock_guard<std::mutex> lock(this->Mutex);
+      if (!this->Running) {
+        return -1;
+      }
+      ticket = this->NextTicket++;
+      this->Queue.emplace_back(ticket, std::move(job));
+    }
+    this->Wake.notify_one();
+    return ticket;
+  }
+
+  void Run(GLFWwindow* shared)
+  {
+    vtkGlfwTrace::SetThreadName("vtkGlfwUploadContext");
+    glfwMakeContextCurrent(shared);
+    std::unique_lock<std::mutex> lock(this->Mutex);
+    for (;;) {
+      this->Wake.wait(lock,
+                      [this] { return this->Quit || !this->Queue.empty(); });
+      if (this->Quit) {
+        break;
+      }
+      auto job = std::move(this->Queue.front());
+      this->Queue.pop_front();
+
+      lock.unlock();
+      VTK_GLFW_TRACE_SCOPE("Upload");
+      Result result = job.second();
+      // the fence must reach the server before other contexts can wait on it
+      result.Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+      glFlush();
+      lock.lock();
+
+      this->Results[job.first] = result;
+      this->Done.notify_all();
+    }
+    lock.unlock();
+    glfwMakeContextCurrent(nullptr);
+  }
+
+  static void Delete(const Result& result)
+  {
+    if (result.Fence) {
+      glDeleteSync(result.Fence);
+    }
+    if (result.Kind == GL_TEXTURE) {
+      glDeleteTextures(1, &result.Name);
+    } else if (result.Kind == GL_PROGRAM) {
+      glDeleteProgram(result.Name);
+    } else {
+      glDeleteBuffers(1, &result.Name);
+    }
+  }
+};
+
+vtkStandardNewMacro(vtkGlfwUploadContext);
+
+//------------------------------------------------------------------------------
+vtkGlfwUploadContext::vtkGlfwUploadContext()
+  : SharedWindow(nullptr)
+  , Internals(new vtkInternals)
+{}
+
+//------------------------------------------------------------------------------
+vtkGlfwUploadContext::~vtkGlfwUploadContext()
+{
+  if (this->IsRunning()) {
+    vtkWarningMacro(<< "Destroyed while running, call Stop() first.");
+  }
+  delete this->Internals;
+}
+
+//------------------------------------------------------------------------------
+bool
+vtkGlfwUploadContext::Start(vtkGlfwOpenGLRenderWindow* window)
+{
+  if (this->IsRunning()) {
+    return true;
+  }
+  if (!window) {
+    vtkErrorMacro(<< "No render window to share with.");
+    return false;
+  }
+
+  this->SharedWindow = window->CreateSharedContextWindow();
+  if (!this->SharedWindow) {
+    vtkErrorMacro(<< "Unable to create a shared GLFW3 context.");
+    return false;
+  }
+
+  auto internals = this->Internals;
+  internals->Quit = false;
+  internals->Running = true;
+  internals->Worker =
+    std::thread([internals, this] { internals->Run(this->SharedWindow); });
+  return true;
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwUploadContext::Stop()
+{
+  auto internals = this->Internals;
+  {
+    std::lock_guard<std::mutex> lock(internals->Mutex);
+    if (!internals->Running) {
+      return;
+    }
+    internals->Running = false;
+    internals->Quit = true;
+    internals->Queue.clear();
+  }
+  internals->Wake.notify_one();
+  internals->Done.notify_all();
+  internals->Worker.join();
+
+  // objects are shared, so the render context can delete the leftovers
+  for (auto& entry : internals->Results) {
+    vtkInternals::Delete(entry.second);
+  }
+  internals->Results.clear();
+
+  glfwDestroyWindow(this->SharedWindow);
+  this->SharedWindow = nullptr;
+}
+
+//------------------------------------------------------------------------------
+bool
+vtkGlfwUploadContext::IsRunning()
+{
+  std::lock_guard<std::mutex> lock(this->Internals->Mutex);
+  return this->Internals->Running;
+}
+
+//------------------------------------------------------------------------------
+vtkIdType
+vtkGlfwUploadContext::UploadBuffer(std::vector<unsigned char> data,
+                                   unsigned int usage)
+{
+  auto payload =
+    std::make_shared<std::vector<unsigned char>>(std::move(data));
+  return this->Internals->Enqueue([payload, usage] {
+    vtkInternals::Result result;
+    result.Kind = GL_BUFFER;
+    glGenBuffers(1, &result.Name);
+    glBindBuffer(GL_ARRAY_BUFFER, result.Name);
+    glBufferData(
+      GL_ARRAY_BUFFER, payload->size(), payload->data(), GLenum(usage));
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    return result;
+  });
+}
+
+//------------------------------------------------------------------------------
+vtkIdType
+vtkGlfwUploadContext::UploadTexture2D(int width,
+                                      int height,
+                                      int internalFormat,
+                                      unsigned int format,
+                                      unsigned int type,
+                                      std::vector<unsigned char> pixels)
+{
+  auto payload =
+    std::make_shared<std::vector<unsigned char>>(std::move(pixels));
+  return this->Internals->Enqueue(
+    [payload, width, height, internalFormat, format, type] {
+      vtkInternals::Result result;
+      result.Kind = GL_TEXTURE;
+      glGenTextures(1, &result.Name);
+      glBindTexture(GL_TEXTURE_2D, result.Name);
+      glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+      glTexImage2D(GL_TEXTURE_2D,
+                   0,
+                   internalFormat,
+                   width,
+                   height,
+                   0,
+                   GLenum(format),
+                   GLenum(type),
+                   payload->data());
+      glBindTexture(GL_TEXTURE_2D, 0);
+      return result;
+    });
+}
+
+//------------------------------------------------------------------------------
+vtkIdType
+vtkGlfwUploadContext::LinkProgram(std::function<unsigned int()> link)
+{
+  return this->Internals->Enqueue([link] {
+    vtkInternals::Result result;
+    result.Kind = GL_PROGRAM;
+    result.Name = link();
+    return result;
+  });
+}
+
+//------------------------------------------------------------------------------
+bool
+vtkGlfwUploadContext::IsReady(vtkIdType ticket)
+{
+  std::lock_guard<std::mutex> lock(this->Internals->Mutex);
+  auto it = this->Internals->Results.find(ticket);
+  if (it == this->Internals->Results.end()) {
+    return false;
+  }
+  auto& result = it->second;
+  if (result.Fence) {
+    GLenum status = glClientWaitSync(result.Fence, 0, 0);
+    if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+      return false;
+    }
+    glDeleteSync(result.Fence);
+    result.Fence = nullptr;
+  }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+unsigned int
+vtkGlfwUploadContext::Acquire(vtkIdType ticket, bool wait)
+{
+  auto internals = this->Internals;
+  std::unique_lock<std::mutex> lock(internals->Mutex);
+  auto it = internals->Results.find(ticket);
+  if (it == internals->Results.end()) {
+    if (!wait || ticket < 0 || ticket >= internals->NextTicket) {
+      return 0;
+    }
+    internals->Done.wait(lock, [&] {
+      it = internals->Results.find(ticket);
+      return it != internals->Results.end() || !internals->Running;
+    });
+    if (it == internals->Results.end()) {
+      return 0;
+    }
+  }
+
+  vtkInternals::Result result = it->second;
+  internals->Results.erase(it);
+  lock.unlock();
+
+  if (result.Fence) {
+    glWaitSync(result.Fence, 0, GL_TIMEOUT_IGNORED);
+    glDeleteSync(result.Fence);
+  }
+  return result.Name;
+}
+
+//------------------------------------------------------------------------------
+int
+vtkGlfwUploadContext::GetNumberOfPendingUploads()
+{
+  std::lock_guard<std::mutex> lock(this->Internals->Mutex);
+  return static_cast<int>(this->Internals->Queue.size());
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwUploadContext::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+
+  os << indent << "SharedWindow: " << this->SharedWindow << "\n";
+  os << indent << "Running: " << this->IsRunning() << "\n";
+  os << indent << "PendingUploads: " << this->GetNumberOfPendingUploads()
+     << "\n";
+}
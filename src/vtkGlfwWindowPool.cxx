@@ -0,0 +1,298 @@
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+#include "vtkCallbackCommand.h"
+#include "vtkCommand.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkRenderWindowInteractor.h"
+#include "vtkRenderer.h"
+#include "vtkRendererCollection.h"
+#include "vtkSmartPointer.h"
+#include <GLFW/glfw3.h>
+
+// clang-format off
+#include "vtkGlfwOpenGLRenderWindow.h"
+#include "vtkGlfwTrace.h"
+#include "vtkGlfwWindowPool.h"
+// clang-format on
+
+class vtkGlfwWindowPool::vtkInternals
+{
+public:
+  struct IdleWindow
+  {
+    vtkGlfwOpenGLRenderWindow* Window;
+    double ReleasedAt;
+  };
+  struct ActiveWindow
+  {
+    vtkGlfwOpenGLRenderWindow* Window;
+    // observers with this tag or higher were added during the job
+    unsigned long FirstJobTag;
+  };
+  // least recently released first
+  std::vector<IdleWindow> Idle;
+  std::vector<ActiveWindow> Active;
+  WindowSetup Setup;
+
+  // observer tags only grow, so the tag an observer would get now
+  // separates the observers added before it from those added after
+  static unsigned long NextObserverTag(vtkObject* object)
+  {
+    vtkNew<vtkCallbackCommand> probe;
+    const unsigned long tag = object->AddObserver(vtkCommand::NoEvent, probe);
+    object->RemoveObserver(tag);
+    return tag + 1;
+  }
+
+  void Destroy(vtkGlfwOpenGLRenderWindow* window)
+  {
+    VTK_GLFW_TRACE_SCOPE("DestroyPooledWindow");
+    window->Finalize();
+    window->Delete();
+  }
+};
+
+vtkStandardNewMacro(vtkGlfwWindowPool);
+
+//------------------------------------------------------------------------------
+vtkGlfwWindowPool::vtkGlfwWindowPool()
+  : MaximumIdleWindows(4)
+  , IdleTimeout(60.0)
+  , NumberOfWindowsCreated(0)
+  , NumberOfReuses(0)
+  , NumberOfWindowsReclaimed(0)
+  , Internals(new vtkInternals)
+{}
+
+//------------------------------------------------------------------------------
+vtkGlfwWindowPool::~vtkGlfwWindowPool()
+{
+  this->Clear();
+  if (!this->Internals->Active.empty()) {
+    vtkWarningMacro(<< this->Internals->Active.size()
+                    << " windows were not released before the pool was "
+                       "destroyed");
+    for (const auto& entry : this->Internals->Active) {
+      this->Internals->Destroy(entry.Window);
+    }
+  }
+  delete this->Internals;
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwWindowPool::SetWindowSetup(const WindowSetup& setup)
+{
+  this->Internals->Setup = setup;
+}
+
+//------------------------------------------------------------------------------
+vtkGlfwOpenGLRenderWindow*
+vtkGlfwWindowPool::NewWindow(int width, int height)
+{
+  VTK_GLFW_TRACE_SCOPE("NewPooledWindow");
+  auto window = vtkGlfwOpenGLRenderWindow::New();
+  // sized without the render SetSize() does on an existing window
+  window->vtkOpenGLRenderWindow::SetSize(width, height);
+  window->SetShowWindow(false);
+  if (this->Internals->Setup) {
+    this->Internals->Setup(window);
+  }
+  window->Initialize();
+  if (!window->GetGenericWindowId()) {
+    vtkErrorMacro(<< "Unable to create a pooled window.");
+    window->Delete();
+    return nullptr;
+  }
+  ++this->NumberOfWindowsCreated;
+  return window;
+}
+
+//------------------------------------------------------------------------------
+vtkGlfwOpenGLRenderWindow*
+vtkGlfwWindowPool::Acquire(int width, int height)
+{
+  if (width <= 0 || height <= 0) {
+    vtkErrorMacro(<< "Invalid window size " << width << "x" << height);
+    return nullptr;
+  }
+  VTK_GLFW_TRACE_SCOPE("AcquireWindow");
+  this->ReclaimIdleWindows();
+
+  auto& idle = this->Internals->Idle;
+  vtkGlfwOpenGLRenderWindow* window = nullptr;
+  if (!idle.empty()) {
+    // a window at the right size skips the framebuffer reallocation,
+    // otherwise the most recently used one is the warmest
+    auto found = std::find_if(
+      idle.rbegin(), idle.rend(), [&](const vtkInternals::IdleWindow& entry) {
+        const int* size = entry.Window->GetSize();
+        return size[0] == width && size[1] == height;
+      });
+    auto entry =
+      found != idle.rend() ? std::prev(found.base()) : std::prev(idle.end());
+    window = entry->Window;
+    idle.erase(entry);
+    ++this->NumberOfReuses;
+    // resized without the render SetSize() does, the job renders when
+    // its scene is ready
+    const int* size = window->GetSize();
+    if (size[0] != width || size[1] != height) {
+      window->vtkOpenGLRenderWindow::SetSize(width, height);
+      glfwSetWindowSize(
+        static_cast<GLFWwindow*>(window->GetGenericWindowId()), width, height);
+    }
+    window->MakeCurrent();
+  } else {
+    window = this->NewWindow(width, height);
+    if (!window) {
+      return nullptr;
+    }
+  }
+  this->Internals->Active.push_back(
+    { window, vtkInternals::NextObserverTag(window) });
+  return window;
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwWindowPool::Release(vtkGlfwOpenGLRenderWindow* window)
+{
+  auto& active = this->Internals->Active;
+  auto found = std::find_if(
+    active.begin(), active.end(), [&](const vtkInternals::ActiveWindow& entry) {
+      return entry.Window == window;
+    });
+  if (found == active.end()) {
+    vtkErrorMacro(<< "Window " << window << " does not belong to this pool.");
+    return;
+  }
+  VTK_GLFW_TRACE_SCOPE("ReleaseWindow");
+  const unsigned long firstJobTag = found->FirstJobTag;
+  active.erase(found);
+
+  // the next job gets a window as plain as a new one
+  window->MakeCurrent();
+  vtkRenderer* ren;
+  while ((ren = window->GetRenderers()->GetFirstRenderer())) {
+    window->RemoveRenderer(ren);
+  }
+  vtkSmartPointer<vtkRenderWindowInteractor> iren = window->GetInteractor();
+  if (iren) {
+    iren->Disable();
+    window->SetInteractor(nullptr);
+    iren->SetRenderWindow(nullptr);
+  }
+  // the job's observers go, those of the window setup stay
+  const unsigned long endTag = vtkInternals::NextObserverTag(window);
+  for (unsigned long tag = firstJobTag; tag < endTag; ++tag) {
+    window->RemoveObserver(tag);
+  }
+
+  if (this->MaximumIdleWindows == 0) {
+    this->Internals->Destroy(window);
+    return;
+  }
+  auto& idle = this->Internals->Idle;
+  if (static_cast<int>(idle.size()) >= this->MaximumIdleWindows) {
+    this->Internals->Destroy(idle.front().Window);
+    idle.erase(idle.begin());
+    ++this->NumberOfWindowsReclaimed;
+  }
+  idle.push_back({ window, glfwGetTime() });
+  this->ReclaimIdleWindows();
+}
+
+//------------------------------------------------------------------------------
+int
+vtkGlfwWindowPool::Reserve(int count, int width, int height)
+{
+  auto& idle = this->Internals->Idle;
+  count = std::min(count, this->MaximumIdleWindows);
+  while (static_cast<int>(idle.size()) < count) {
+    vtkGlfwOpenGLRenderWindow* window = this->NewWindow(width, height);
+    if (!window) {
+      break;
+    }
+    idle.push_back({ window, glfwGetTime() });
+  }
+  return static_cast<int>(idle.size());
+}
+
+//------------------------------------------------------------------------------
+double
+vtkGlfwWindowPool::GetReclaimDelay()
+{
+  if (this->Internals->Idle.empty() || this->IdleTimeout < 0.0) {
+    return -1.0;
+  }
+  const double oldest = this->Internals->Idle.front().ReleasedAt;
+  return std::max(0.0, oldest + this->IdleTimeout - glfwGetTime());
+}
+
+//------------------------------------------------------------------------------
+int
+vtkGlfwWindowPool::ReclaimIdleWindows()
+{
+  if (this->IdleTimeout < 0.0) {
+    return 0;
+  }
+  auto& idle = this->Internals->Idle;
+  const double expired = glfwGetTime() - this->IdleTimeout;
+  auto end = std::stable_partition(
+    idle.begin(), idle.end(), [&](const vtkInternals::IdleWindow& entry) {
+      return entry.ReleasedAt > expired;
+    });
+  int reclaimed = static_cast<int>(idle.end() - end);
+  for (auto entry = end; entry != idle.end(); ++entry) {
+    this->Internals->Destroy(entry->Window);
+  }
+  idle.erase(end, idle.end());
+  this->NumberOfWindowsReclaimed += reclaimed;
+  return reclaimed;
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwWindowPool::Clear()
+{
+  for (const auto& entry : this->Internals->Idle) {
+    this->Internals->Destroy(entry.Window);
+  }
+  this->Internals->Idle.clear();
+}
+
+//------------------------------------------------------------------------------
+int
+vtkGlfwWindowPool::GetNumberOfIdleWindows()
+{
+  return static_cast<int>(this->Internals->Idle.size());
+}
+
+//------------------------------------------------------------------------------
+int
+vtkGlfwWindowPool::GetNumberOfActiveWindows()
+{
+  return static_cast<int>(this->Internals->Active.size());
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwWindowPool::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+
+  os << indent << "MaximumIdleWindows: " << this->MaximumIdleWindows << "\n";
+  os << indent << "IdleTimeout: " << this->IdleTimeout << "\n";
+  os << indent << "IdleWindows: " << this->GetNumberOfIdleWindows() << "\n";
+  os << indent << "ActiveWindows: " << this->GetNumberOfActiveWindows()
+     << "\n";
+  os << indent << "NumberOfWindowsCreated: " << this->NumberOfWindowsCreated
+     << "\n";
+  os << indent << "NumberOfReuses: " << this->NumberOfReuses << "\n";
+  os << indent << "NumberOfWindowsReclaimed: "
+     << this->NumberOfWindowsReclaimed << "\n";
+}
@@ -0,0 +1,87 @@
+#include "vtkGlfwWorkerPool.h"
+
+#include "vtkGlfwTrace.h"
+
+#include <algorithm>
+
+//------------------------------------------------------------------------------
+vtkGlfwWorkerPool::vtkGlfwWorkerPool(int numberOfThreads)
+  : Busy(0)
+  , Quit(false)
+{
+  numberOfThreads = std::max(1, numberOfThreads);
+  for (int i = 0; i < numberOfThreads; ++i) {
+    this->Threads.emplace_back([this] { this->Run(); });
+  }
+}
+
+//------------------------------------------------------------------------------
+vtkGlfwWorkerPool::~vtkGlfwWorkerPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    this->Quit = true;
+  }
+  this->Wake.notify_all();
+  for (auto& thread : this->Threads) {
+    thread.join();
+  }
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwWorkerPool::Submit(std::function<void()> task)
+{
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    this->Tasks.push_back(std::move(task));
+  }
+  this->Wake.notify_one();
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwWorkerPool::Wait()
+{
+  std::unique_lock<std::mutex> lock(this->Mutex);
+  this->Idle.wait(lock,
+                  [this] { return this->Tasks.empty() && this->Busy == 0; });
+}
+
+//------------------------------------------------------------------------------
+int
+vtkGlfwWorkerPool::GetNumberOfPendingTasks()
+{
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  return static_cast<int>(this->Tasks.size()) + this->Busy;
+}
+
+//------------------------------------------------------------------------------
+void
+vtkGlfwWorkerPool::Run()
+{
+  std::unique_lock<std::mutex> lock(this->Mutex);
+  for (;;) {
+    this->Wake.wait(lock,
+                    [this] { return this->Quit || !this->Tasks.empty(); });
+    // drain the queue before honouring Quit
+    if (this->Tasks.empty()) {
+      break;
+    }
+    auto task = std::move(this->Tasks.front());
+    this->Tasks.pop_front();
+    ++this->Busy;
+
+    lock.unlock();
+    {
+      VTK_GLFW_TRACE_SCOPE("WorkerTask");
+      task();
+    }
+    lock.lock();
+
+    --this->Busy;
+    if (this->Tasks.empty() && this->Busy == 0) {
+      this->Idle.notify_all();
+    }
+  }
+}
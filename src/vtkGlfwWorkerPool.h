@@ -0,0 +1,76 @@
+#ifndef vtkGlfwWorkerPool_h
+#define vtkGlfwWorkerPool_h
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Fixed-size pool of threads running queued tasks in order of submission.
+ * Used internally to move encoding and I/O off the render thread.
+ */
+class vtkGlfwWorkerPool
+{
+public:
+  /**
+   * Start numberOfThreads workers, at least one.
+   */
+  explicit vtkGlfwWorkerPool(int numberOfThreads);
+
+  /**
+   * Runs every queued task, then joins the workers.
+   */
+  ~vtkGlfwWorkerPool();
+
+  /**
+   * Queue a task. Thread safe.
+   */
+  void Submit(std::function<void()> task);
+
+  /**
+   * Queue task(std::move(value)), for values that cannot be copied into a
+   * std::function. The value is freed even if the task never runs.
+   */
+  template <typename T, typename Task>
+  void Submit(std::unique_ptr<T> value, Task task)
+  {
+    auto shared = std::make_shared<std::unique_ptr<T>>(std::move(value));
+    this->Submit(
+      std::function<void()>([shared, task] { task(std::move(*shared)); }));
+  }
+
+  /**
+   * Block until the queue is empty and no task is running.
+   */
+  void Wait();
+
+  /**
+   * Number of tasks queued or running.
+   */
+  int GetNumberOfPendingTasks();
+
+  int GetNumberOfThreads() const
+  {
+    return static_cast<int>(this->Threads.size());
+  }
+
+private:
+  vtkGlfwWorkerPool(const vtkGlfwWorkerPool&) = delete;
+  void operator=(const vtkGlfwWorkerPool&) = delete;
+
+  void Run();
+
+  std::mutex Mutex;
+  std::condition_variable Wake;
+  std::condition_variable Idle;
+  std::deque<std::function<void()>> Tasks;
+  std::vector<std::thread> Threads;
+  int Busy;
+  bool Quit;
+};
+
+#endif